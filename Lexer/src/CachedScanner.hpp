@@ -0,0 +1,144 @@
+#ifndef CACHED_SCANNER_H_
+#define CACHED_SCANNER_H_
+#include "Lexeme.hpp"
+#include "Matcher.hpp"
+#include "MappedFile.hpp"
+#include "TokenBatch.hpp"
+#include "TokenCache.hpp"
+#include <queue>
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+
+// 带磁盘缓存的扫描器。源文件被只读映射并计算内容摘要，缓存命中时直接映射缓存文件解码词素流，
+// 不再运行状态机；未命中时扫描整个源文件，写入缓存后再从编码结果中交付词素。
+// 对外的接口与MappedScanner一致，交付的词素与直接扫描的结果逐个相同。
+// Linear为true时保证最坏情况下的线性扫描，见Matcher。
+template <class ArrayDFA, bool Linear = false>
+class CachedScanner {
+public:
+    CachedScanner(std::initializer_list<fs::path> sources, const fs::path& cacheDirectory, std::uint32_t firstSource = 0)
+        : m_firstSource(firstSource), m_cache(cacheDirectory, TokenCache::fingerprintOf<ArrayDFA>()) {
+        for (auto& filePath : sources) {
+            m_sources.push(filePath);
+        }
+        loadSource();
+    }
+
+    Lexeme nextLexeme() {
+        // 当前源文件读尽时，切换至下一个源文件
+        while (m_reader.empty() && loadSource()) {}
+        if (m_reader.empty()) { // 输入结束
+            return { Lexeme::invalid, currentSource(), m_offset, 0 };
+        }
+        const auto [label, length] = m_reader.next();
+        const auto lexeme = Lexeme { label, currentSource(), m_offset, length };
+        m_offset += length;
+        return lexeme;
+    }
+
+    // 批量扫描至多max个词素并覆盖batch原有的内容，返回扫描到的词素数量，输入结束时返回0
+    size_t scan(TokenBatch& batch, size_t max) {
+        batch.clear();
+        max = std::min(max, batch.capacity());
+        while (batch.size() < max) {
+            while (m_reader.empty() && loadSource()) {}
+            if (m_reader.empty()) { // 输入结束
+                break;
+            }
+            const auto [label, length] = m_reader.next();
+            batch.push(label, currentSource(), m_offset, length);
+            m_offset += length;
+        }
+        return batch.size();
+    }
+
+    size_t scan(TokenBatch& batch) {
+        return scan(batch, batch.capacity());
+    }
+
+    // 词素的文本视图，在扫描器析构前有效
+    std::string_view view(const Lexeme& lexeme) const {
+        const auto index = lexeme.source - m_firstSource;
+        if (index >= m_files.size()) { // 没有任何源文件时的输入结束
+            return {};
+        }
+        return lexeme.view(m_files[index].view());
+    }
+
+    // 显式复制出词素的文本
+    std::string str(const Lexeme& lexeme) const {
+        return std::string(view(lexeme));
+    }
+
+    // 打开失败的源文件编号，按扫描顺序排列。这些源文件不产生任何词素
+    const std::vector<std::uint32_t>& failures() const {
+        return m_failures;
+    }
+
+    // 命中缓存的源文件数量
+    size_t hits() const {
+        return m_hits;
+    }
+
+private:
+    bool loadSource() { // 映射下一个源文件并取得其词素流，所有源文件耗尽时返回false
+        while (true) {
+            if (m_sources.empty()) {
+                return false;
+            }
+            m_files.emplace_back(m_sources.front()); // 打开失败的源文件同样占据一个编号
+            m_sources.pop();
+            if (m_files.back().isOpen()) {
+                break;
+            }
+            m_failures.push_back(currentSource());
+        }
+        m_offset = 0;
+
+        const auto source = m_files.back().view();
+        const auto contentDigest = TokenCache::digest(source);
+        if (m_cache.find(source, contentDigest, m_entry)) {
+            m_hits += 1;
+            m_reader = TokenCache::Reader(m_entry.data());
+            return true;
+        }
+        // 未命中：扫描整个源文件并写入缓存
+        TokenCache::Writer writer;
+        m_matcher.reset();
+        for (auto begin = source.data(), end = begin + source.size(); begin != end; ) {
+            const auto [label, length] = m_matcher.match(begin, end);
+            writer.push(label, length);
+            begin += length;
+        }
+        m_encoded = writer.finish(source.size(), contentDigest, m_cache.fingerprint());
+        m_cache.store(contentDigest, m_encoded);
+        m_reader = TokenCache::Reader(m_encoded.data());
+        return true;
+    }
+
+    std::uint32_t currentSource() const {
+        return static_cast<std::uint32_t>(m_firstSource + m_files.size() - 1);
+    }
+
+private:
+    // 文件映射相关成员
+    std::queue<fs::path> m_sources;
+    std::vector<MappedFile> m_files;
+    std::vector<std::uint32_t> m_failures;
+    std::uint32_t m_firstSource;
+
+    // 缓存相关成员
+    TokenCache m_cache;
+    MappedFile m_entry;             // 命中时映射的缓存文件
+    std::vector<char> m_encoded;    // 未命中时编码的词素流
+    TokenCache::Reader m_reader;
+    std::uint64_t m_offset = 0;     // 下一个词素在当前源文件中的偏移
+    size_t m_hits = 0;
+
+    // 状态机相关成员
+    Matcher<ArrayDFA, Linear> m_matcher;
+};
+
+#endif // !CACHED_SCANNER_H_
@@ -0,0 +1,144 @@
+#ifndef CHUNKED_SCANNER_H_
+#define CHUNKED_SCANNER_H_
+#include "Matcher.hpp"
+#include "MappedFile.hpp"
+#include "TokenBatch.hpp"
+#include "ThreadPool.hpp"
+#include <future>
+#include <memory>
+#include <vector>
+#include <cstring>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+
+// 单个大文件的分块推测并行扫描器。
+// 文件被切分为若干块，每块从一个推测的词素边界开始独立扫描；
+// 之后按顺序拼接各块的结果，若真实的扫描位置落在推测的词素边界之外，
+// 则从真实位置顺序扫描修正，直到与推测结果的某个词素边界重合为止。
+// 由于最长匹配从同一位置出发的结果总是相同，拼接结果与顺序扫描逐字节一致。
+template <class ArrayDFA, bool Linear = false>
+class ChunkedScanner {
+public:
+    constexpr static size_t defaultChunkSize = 16 * 1024 * 1024;
+
+    // 推测起点在块首之后寻找换行的最大距离
+    constexpr static size_t boundaryWindow = 4096;
+
+    // 源文件无法打开时抛出std::runtime_error
+    ChunkedScanner(const fs::path& path, std::uint32_t source = 0,
+        size_t chunkSize = defaultChunkSize, size_t threads = ThreadPool::defaultThreads())
+        : m_file(path), m_source(source), m_chunkSize(std::max<size_t>(chunkSize, 1)), m_threads(threads) {
+        if (!m_file.isOpen()) {
+            throw std::runtime_error("cannot open " + path.string());
+        }
+    }
+
+    // 并行扫描整个文件，按顺序将词素批交给consumer(const TokenBatch&)
+    template <class Consumer>
+    void run(Consumer&& consumer) {
+        const auto chunks = m_file.size() / m_chunkSize + (m_file.size() % m_chunkSize != 0);
+        ThreadPool pool(m_threads);
+        const auto window = pool.size() * 2;
+        std::vector<std::future<std::vector<Lexeme>>> results(chunks);
+
+        auto submit = [&](size_t i) {
+            auto promise = std::make_shared<std::promise<std::vector<Lexeme>>>();
+            results[i] = promise->get_future();
+            pool.submit([this, promise, i] {
+                try {
+                    promise->set_value(scanChunk(i));
+                } catch (...) {
+                    promise->set_exception(std::current_exception());
+                }
+            });
+        };
+
+        for (size_t i = 0; i < std::min(window, chunks); i++) {
+            submit(i);
+        }
+        Matcher<ArrayDFA, Linear> matcher;
+        TokenBatch batch;
+        auto emit = [&](const Lexeme& lexeme) {
+            batch.push(lexeme);
+            if (batch.full()) {
+                consumer(batch);
+                batch.clear();
+            }
+        };
+        auto position = m_file.begin(); // 真实的扫描位置
+        for (size_t i = 0; i < chunks; i++) {
+            const auto speculated = results[i].get();
+            if (i + window < chunks) {
+                submit(i + window);
+            }
+            const auto chunkEnd = m_file.begin() + i * m_chunkSize + std::min(m_chunkSize, m_file.size() - i * m_chunkSize);
+            // 修正阶段：从真实位置顺序扫描，直到与推测的某个词素边界重合
+            auto spec = speculated.end();
+            while (position < chunkEnd) {
+                spec = std::lower_bound(speculated.begin(), speculated.end(), offsetOf(position),
+                    [](const Lexeme& lexeme, std::uint64_t offset) { return lexeme.offset < offset; });
+                if (spec != speculated.end() && spec->offset == offsetOf(position)) {
+                    break;
+                }
+                const auto [label, length] = matcher.match(position, m_file.end());
+                emit({ label, m_source, offsetOf(position), length });
+                position += length;
+                spec = speculated.end();
+            }
+            // 拼接阶段：剩下的推测结果与顺序扫描一致
+            for (; spec != speculated.end(); ++spec) {
+                emit(*spec);
+                position = m_file.begin() + spec->offset + spec->length;
+            }
+        }
+        if (!batch.empty()) {
+            consumer(batch);
+        }
+    }
+
+    std::string_view view(const Lexeme& lexeme) const {
+        return lexeme.view(m_file.view());
+    }
+
+    std::string str(const Lexeme& lexeme) const {
+        return std::string(view(lexeme));
+    }
+
+private:
+    // 推测扫描第i块：从块首之后的第一个换行处开始，扫描所有起始于本块内的词素
+    std::vector<Lexeme> scanChunk(size_t i) const {
+        const auto chunkBegin = m_file.begin() + i * m_chunkSize;
+        const auto chunkEnd = chunkBegin + std::min(m_chunkSize, m_file.size() - i * m_chunkSize);
+        auto position = speculativeStart(chunkBegin, chunkEnd);
+        Matcher<ArrayDFA, Linear> matcher;
+        std::vector<Lexeme> lexemes;
+        while (position < chunkEnd) {
+            const auto [label, length] = matcher.match(position, m_file.end());
+            lexemes.push_back({ label, m_source, offsetOf(position), length });
+            position += length;
+        }
+        return lexemes;
+    }
+
+    const char* speculativeStart(const char* chunkBegin, const char* chunkEnd) const {
+        if (chunkBegin == m_file.begin()) { // 首块的起点就是真实的词素边界
+            return chunkBegin;
+        }
+        const auto limit = std::min<size_t>(chunkEnd - chunkBegin, boundaryWindow);
+        const auto newline = static_cast<const char*>(std::memchr(chunkBegin, '\n', limit));
+        return newline != nullptr ? newline + 1 : chunkBegin;
+    }
+
+    std::uint64_t offsetOf(const char* position) const {
+        return static_cast<std::uint64_t>(position - m_file.begin());
+    }
+
+private:
+    MappedFile m_file;
+    std::uint32_t m_source;
+    size_t m_chunkSize;
+    size_t m_threads;
+};
+
+#endif // !CHUNKED_SCANNER_H_
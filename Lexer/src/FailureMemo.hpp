@@ -0,0 +1,124 @@
+#ifndef FAILURE_MEMO_H_
+#define FAILURE_MEMO_H_
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include "SelfLoop.hpp"
+
+// 记录回溯中失败的(状态, 位置)对，即从该位置以该状态出发不可能再到达接受状态。
+// 前进时遇到已失败的对便可立即停止，使最长匹配的总代价与输入长度成线性关系。
+// 位置按行存储，每行是States个状态的位图，已扫描过的行会被成批丢弃。
+// 自环状态成段跳过，其失败按段记录，每段只占一项，见failRun。
+template <size_t States>
+class FailureMemo {
+public:
+    // 清空所有记录，并以base作为之后位置的起点
+    void reset(std::uint64_t base) {
+        m_base = base;
+        m_start = base;
+        m_bits.clear();
+        for (auto& runs : m_runs) {
+            runs.clear();
+        }
+    }
+
+    bool failed(int state, std::uint64_t position) const {
+        const auto row = position - m_base;
+        if (row >= rows()) {
+            return false;
+        }
+        return (m_bits[row * stride + state / 64] >> (state % 64)) & 1;
+    }
+
+    void fail(int state, std::uint64_t position) {
+        const auto row = position - m_base;
+        if (row >= rows()) {
+            m_bits.resize((row + 1) * stride);
+        }
+        m_bits[row * stride + state / 64] |= std::uint64_t(1) << (state % 64);
+    }
+
+    // 以自环状态state从[from, to]中任一位置出发都不可能再接受。
+    // 自环段的终点由字节内容决定，同一状态的失败段要么终点相同而合并，要么互不相交，按终点有序存放
+    void failRun(int state, std::uint64_t from, std::uint64_t to) {
+        auto& runs = m_runs[state];
+        auto live = std::lower_bound(runs.begin(), runs.end(), m_start, endsBefore);
+        if ((live - runs.begin()) * 2 >= runs.end() - runs.begin()) { // 失效的段过半时才整理
+            live = runs.erase(runs.begin(), live);
+        }
+        const auto run = std::lower_bound(live, runs.end(), to, endsBefore);
+        if (run != runs.end() && run->from <= from) { // 已被记录过的段覆盖
+            return;
+        }
+        if (run != runs.end() && run->to == to) {
+            run->from = from;
+        } else {
+            runs.insert(run, { from, to });
+        }
+    }
+
+    bool failedRun(int state, std::uint64_t position) const {
+        const auto& runs = m_runs[state];
+        const auto run = std::lower_bound(runs.begin(), runs.end(), position, endsBefore);
+        return run != runs.end() && run->from <= position;
+    }
+
+    // 按ArrayDFA的状态查询与记录：自环状态的失败按段记录，其余状态逐个位置记录。
+    // 以状态state连续经过length个位置后在end处失败，即自环段为[end - length + 1, end]
+    template <class ArrayDFA>
+    bool failed(int state, std::uint64_t position) const {
+        if constexpr (SelfLoop<ArrayDFA>::enabled) {
+            if (SelfLoop<ArrayDFA>::loops(state)) {
+                return failedRun(ArrayDFA::row(state), position);
+            }
+        }
+        return failed(ArrayDFA::row(state), position);
+    }
+
+    template <class ArrayDFA>
+    void fail(int state, std::uint64_t length, std::uint64_t end) {
+        if constexpr (SelfLoop<ArrayDFA>::enabled) {
+            if (SelfLoop<ArrayDFA>::loops(state)) {
+                failRun(ArrayDFA::row(state), end - length + 1, end);
+                return;
+            }
+        }
+        fail(ArrayDFA::row(state), end);
+    }
+
+    // 词素起点已前进至position，之前的位置不会再被查询
+    void advance(std::uint64_t position) {
+        m_start = position;
+        const auto dead = position - m_base;
+        if (dead >= rows()) { // 所有行都已失效，失败段在记录新段时再整理
+            m_base = position;
+            m_bits.clear();
+        } else if (dead * 2 >= rows()) { // 失效的行过半时才整理，保证均摊代价为常数
+            m_bits.erase(m_bits.begin(), m_bits.begin() + dead * stride);
+            m_base = position;
+        }
+    }
+
+private:
+    struct Run {
+        std::uint64_t from;
+        std::uint64_t to;
+    };
+
+    static bool endsBefore(const Run& run, std::uint64_t position) {
+        return run.to < position;
+    }
+
+    constexpr static size_t stride = (States + 63) / 64; // 每行占用的字数
+
+    size_t rows() const { return m_bits.size() / stride; }
+
+    std::uint64_t m_base = 0;
+    std::vector<std::uint64_t> m_bits;
+    std::uint64_t m_start = 0; // 当前词素的起点
+    std::array<std::vector<Run>, States> m_runs; // 各状态的失败段
+};
+
+#endif // !FAILURE_MEMO_H_
@@ -0,0 +1,153 @@
+#ifndef INCREMENTAL_SCANNER_H_
+#define INCREMENTAL_SCANNER_H_
+#include "Lexeme.hpp"
+#include "Matcher.hpp"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <stdexcept>
+
+// 增量扫描器，供编辑器在每次编辑后更新词素流。
+// 每个词素都从初始状态开始匹配，故词素边界处的状态机状态总是初始状态，
+// 词素流完全由起始位置及其后被检查的字节决定。编辑后只需从第一个检查范围触及编辑处的词素开始重新扫描，
+// 直到扫描位置在编辑处之后与旧词素的起点重合，其后的旧词素原样复用。
+// 词素保存在以编辑处为间隙的两个栈中：间隙前的词素记录从文本开头起的偏移，
+// 间隙后的词素记录到文本末尾的距离，于是编辑不改变任何旧词素的记录。
+// 一次更新的代价只与编辑附近的词素数量以及间隙移动的距离有关，连续的局部编辑几乎不移动间隙。
+template <class ArrayDFA>
+class IncrementalScanner {
+public:
+    // 一次更新对词素流的改变：从下标first开始的removed个旧词素被替换为inserted个新词素
+    struct Change {
+        size_t first;
+        size_t removed;
+        size_t inserted;
+    };
+
+    explicit IncrementalScanner(std::uint32_t source = 0) : m_source(source) {}
+
+    // 全量扫描text。text由使用者持有，须在下一次reset或update之前保持有效
+    void reset(std::string_view text) {
+        m_text = text;
+        m_front.clear();
+        m_back.clear();
+        m_maxExamined = 0;
+        rescan(0, 0);
+    }
+
+    // text为编辑后的全文，编辑将原文本的[offset, offset + removed)替换为text的[offset, offset + inserted)。
+    // 编辑范围越出原文本或与text的长度不符时抛出std::invalid_argument，词素流保持不变
+    Change update(std::string_view text, size_t offset, size_t removed, size_t inserted) {
+        const auto size = m_text.size();
+        if (offset > size || removed > size - offset || text.size() != size - removed + inserted) {
+            throw std::invalid_argument("edit does not match the text size");
+        }
+        moveGap(offset);
+        // 间隙前检查范围越过offset的词素也受编辑影响，它们的起点距离offset不超过最长的检查范围
+        auto first = m_front.size();
+        for (auto i = m_front.size(); i > 0 && m_front[i - 1].offset + m_maxExamined > offset; i--) {
+            if (m_front[i - 1].offset + m_front[i - 1].examined > offset) {
+                first = i - 1;
+            }
+        }
+        const auto restart = (first == m_front.size()) ? end() : m_front[first].offset;
+        const auto frontRemoved = m_front.size() - first;
+        m_front.resize(first);
+
+        m_text = text;
+        const auto backRemoved = rescan(restart, offset + inserted);
+        return { first, frontRemoved + backRemoved, m_front.size() - first };
+    }
+
+    size_t size() const {
+        return m_front.size() + m_back.size();
+    }
+
+    Lexeme operator[](size_t i) const {
+        if (i < m_front.size()) {
+            return m_front[i].lexeme(m_source);
+        }
+        auto token = m_back[m_back.size() - 1 - (i - m_front.size())];
+        token.offset = m_text.size() - token.offset;
+        return token.lexeme(m_source);
+    }
+
+    // 词素的文本视图，在text失效前有效
+    std::string_view view(const Lexeme& lexeme) const {
+        return lexeme.view(m_text);
+    }
+
+    std::string str(const Lexeme& lexeme) const {
+        return std::string(view(lexeme));
+    }
+
+private:
+    struct Token {
+        std::uint64_t offset; // 间隙前为从文本开头起的偏移，间隙后为到文本末尾的距离
+        std::uint32_t label;
+        std::uint64_t length;
+        std::uint64_t examined; // 匹配时检查过的字节数，见Matcher::examined
+
+        Lexeme lexeme(std::uint32_t source) const {
+            return { label, source, offset, length };
+        }
+    };
+
+    std::uint64_t end() const { // 间隙前最后一个词素的末尾
+        return m_front.empty() ? 0 : m_front.back().offset + m_front.back().length;
+    }
+
+    void moveGap(size_t offset) { // 使间隙前恰好是起点在offset之前的词素
+        const auto size = m_text.size();
+        while (!m_front.empty() && m_front.back().offset >= offset) {
+            auto token = m_front.back();
+            token.offset = size - token.offset;
+            m_front.pop_back();
+            m_back.push_back(token);
+        }
+        while (!m_back.empty() && size - m_back.back().offset < offset) {
+            auto token = m_back.back();
+            token.offset = size - token.offset;
+            m_back.pop_back();
+            m_front.push_back(token);
+        }
+    }
+
+    // 从position开始重新扫描，越过stable之后一旦与间隙后某个词素的起点重合便停止，
+    // 返回被丢弃的间隙后词素的数量
+    size_t rescan(std::uint64_t position, std::uint64_t stable) {
+        const auto size = m_text.size();
+        size_t removed = 0;
+        while (position < size) {
+            if (position >= stable) {
+                // 起点已被新词素越过的旧词素作废，与编辑范围重叠的旧词素到末尾的距离可能超过新文本的长度
+                while (!m_back.empty() && m_back.back().offset > size - position) {
+                    m_back.pop_back();
+                    removed += 1;
+                }
+                if (!m_back.empty() && m_back.back().offset == size - position) { // 收敛
+                    return removed;
+                }
+            }
+            const auto [label, length] = m_matcher.match(m_text.data() + position, m_text.data() + size);
+            const auto examined = m_matcher.examined();
+            m_front.push_back({ position, label, length, examined });
+            m_maxExamined = std::max(m_maxExamined, examined);
+            position += length;
+        }
+        removed += m_back.size();
+        m_back.clear();
+        return removed;
+    }
+
+private:
+    std::uint32_t m_source;
+    std::string_view m_text;
+    std::vector<Token> m_front; // 间隙前的词素，按位置顺序
+    std::vector<Token> m_back;  // 间隙后的词素，栈顶最靠近间隙
+    std::uint64_t m_maxExamined = 0;
+    Matcher<ArrayDFA> m_matcher;
+};
+
+#endif // !INCREMENTAL_SCANNER_H_
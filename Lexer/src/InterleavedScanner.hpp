@@ -0,0 +1,231 @@
+#ifndef INTERLEAVED_SCANNER_H_
+#define INTERLEAVED_SCANNER_H_
+#include "Lexeme.hpp"
+#include "MappedFile.hpp"
+#include "TokenBatch.hpp"
+#include <array>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// 交错扫描器：在一个线程内让Lanes个源文件同时前进。
+// 查表式状态机的每一步都依赖上一步读出的状态，单个输入只是一条串行的读取链，处理器的读取端口大多空闲。
+// 各通道在同一个循环中轮流前进一个字节，通道之间没有依赖，它们的读取链在乱序执行中相互重叠。
+// 每个通道独立做最长匹配，只记住最后一次接受的位置，词素结束后从该位置重新开始；
+// 某个通道的源文件读尽时立即换上下一个源文件，使所有通道尽量保持忙碌。
+// 各源文件的词素先按源文件缓存，再按源文件在构造参数中的顺序交付，结果与MappedScanner逐个相同。
+// 通道逐字节查表，不做自环加速：适合没有自环的长词素；词素主体落在自环状态上时，
+// MappedScanner用SelfLoop成段跳过反而更快，词素很短时每个词素的结束与重启占了大部分时间，也不如MappedScanner。
+// 对比见test/unittest_scanner.cpp中的benchmark_scanner，以--bench运行。
+template <class ArrayDFA, size_t Lanes = 4>
+class InterleavedScanner {
+    static_assert(Lanes != 0 && Lanes <= 64, "between 1 and 64 lanes are supported");
+
+public:
+    InterleavedScanner(std::initializer_list<fs::path> sources, std::uint32_t firstSource = 0)
+        : m_paths(sources), m_firstSource(firstSource), m_files(m_paths.size()), m_lexemes(m_paths.size()), m_done(m_paths.size()), m_failed(m_paths.size()) {}
+
+    // 扫描所有源文件，按源文件的顺序将词素批交给consumer(const TokenBatch&)
+    template <class Consumer>
+    void run(Consumer&& consumer) {
+        for (auto& lane : m_lanes) {
+            load(lane);
+        }
+        run(consumer, std::make_index_sequence<Lanes>{});
+        if (!m_batch.empty()) {
+            consumer(m_batch);
+            m_batch.clear();
+        }
+    }
+
+    // 词素的文本视图，在扫描器析构前有效
+    std::string_view view(const Lexeme& lexeme) const {
+        const auto index = lexeme.source - m_firstSource;
+        if (index >= m_files.size()) {
+            return {};
+        }
+        return lexeme.view(m_files[index].view());
+    }
+
+    std::string str(const Lexeme& lexeme) const {
+        return std::string(view(lexeme));
+    }
+
+    // 打开失败的源文件编号，按源文件的顺序排列，在run之后有效。这些源文件不产生任何词素
+    std::vector<std::uint32_t> failures() const {
+        std::vector<std::uint32_t> result;
+        for (size_t i = 0; i < m_failed.size(); i++) {
+            if (m_failed[i]) {
+                result.push_back(static_cast<std::uint32_t>(m_firstSource + i));
+            }
+        }
+        return result;
+    }
+
+private:
+    constexpr static auto idle = static_cast<size_t>(-1);
+
+    struct Lane {
+        size_t source = idle;         // 正在扫描的源文件下标，idle表示通道空闲
+        const char* first = nullptr;  // 源文件的开头
+        const char* begin = nullptr;  // 当前词素的起点
+        const char* forward = nullptr;
+        const char* accept = nullptr; // 最后一次接受的位置
+        const char* end = nullptr;
+        std::uint32_t label = 0;      // 最后一次接受的标签
+    };
+
+    // 各通道的状态与前进位置是局部变量，按常量下标展开后留在寄存器中，读取链上没有经过内存的状态。
+    // 内层循环中没有函数调用：通道无法前进时只在掩码中记下，退出内层循环后再结束其词素。
+    template <class Consumer, size_t... I>
+    void run(Consumer& consumer, std::index_sequence<I...>) {
+        std::array<int, Lanes> states { (static_cast<void>(I), static_cast<int>(m_dfa.initial_state))... };
+        std::array<const char*, Lanes> forwards { m_lanes[I].forward... };
+        std::uint64_t stopped = 0; // 第i位表示第i个通道已停下
+        std::uint64_t idleLanes = 0; // 第i位表示第i个通道空闲，不参与无检查的轮次
+        auto advance = [&](auto index, auto checked) {
+            constexpr auto i = decltype(index)::value;
+            auto& lane = m_lanes[i];
+            if constexpr (decltype(checked)::value) {
+                if (forwards[i] == lane.end) {
+                    stopped |= std::uint64_t(1) << i;
+                    return;
+                }
+            } else if (idleLanes >> i & 1) {
+                return;
+            }
+            const auto nextState = m_dfa.trans(states[i], *forwards[i]);
+            if (nextState == m_dfa.null_state) {
+                stopped |= std::uint64_t(1) << i;
+                return;
+            }
+            states[i] = nextState;
+            ++forwards[i];
+            if constexpr (!ArrayDFA::backtrack_free) { // 无需回溯时停下的状态即可决定词素，不必逐字节记录
+                if (const auto accepted = m_dfa.label(nextState); accepted != 0) {
+                    lane.label = accepted;
+                    lane.accept = forwards[i];
+                }
+            }
+        };
+        auto restart = [&](auto index) {
+            constexpr auto i = decltype(index)::value;
+            auto& lane = m_lanes[i];
+            if ((stopped >> i & 1) == 0 || lane.source == idle) {
+                return;
+            }
+            if constexpr (ArrayDFA::backtrack_free) {
+                lane.label = m_dfa.label(states[i]);
+                lane.accept = forwards[i];
+            }
+            forwards[i] = stop(lane, consumer);
+            states[i] = m_dfa.initial_state;
+        };
+        while (m_active != 0) {
+            stopped = 0;
+            idleLanes = ((m_lanes[I].source == idle ? std::uint64_t(1) << I : 0) | ...);
+            // 非空闲的通道都至少还剩rounds个字节，这些轮次无需检查输入末尾，空闲的通道直接略过；
+            // 词素结束后通道从不超过当前位置的地方重新开始，剩余的字节数不会因此减少
+            for (auto rounds = std::min({ (idleLanes >> I & 1 ? static_cast<size_t>(-1) : static_cast<size_t>(m_lanes[I].end - forwards[I]))... });
+                 rounds != 0 && stopped == 0; rounds--) {
+                (advance(std::integral_constant<size_t, I>{}, std::false_type{}), ...);
+            }
+            if (stopped == 0) {
+                (advance(std::integral_constant<size_t, I>{}, std::true_type{}), ...);
+            }
+            (restart(std::integral_constant<size_t, I>{}), ...);
+        }
+    }
+
+    // 结束通道的当前词素，源文件读尽时交付并换上下一个源文件，返回通道新的前进位置
+    template <class Consumer>
+    const char* stop(Lane& lane, Consumer& consumer) {
+        if (!finish(lane)) {
+            deliver(consumer);
+            load(lane);
+        }
+        return lane.forward;
+    }
+
+    // 为通道映射下一个源文件，没有剩余的源文件时通道变为空闲
+    void load(Lane& lane) {
+        if (lane.source != idle) {
+            lane.source = idle;
+            m_active -= 1;
+        }
+        if (m_nextSource == m_paths.size()) {
+            lane.forward = lane.end = nullptr; // 空闲通道不再前进
+            return;
+        }
+        m_active += 1;
+        const auto source = m_nextSource++;
+        m_files[source] = MappedFile(m_paths[source]);
+        m_failed[source] = !m_files[source].isOpen(); // 打开失败的源文件按空文件扫描
+        lane.source = source;
+        lane.first = m_files[source].begin();
+        lane.end = m_files[source].end();
+        restart(lane, lane.first);
+    }
+
+    void restart(Lane& lane, const char* begin) {
+        lane.begin = begin;
+        lane.forward = begin;
+        lane.accept = begin;
+        lane.label = 0;
+    }
+
+    // 状态机停下时结束当前词素并从其末尾重新开始，源文件读尽时返回false
+    bool finish(Lane& lane) {
+        if (lane.begin == lane.end) {
+            m_done[lane.source] = true;
+            return false;
+        }
+        auto& lexemes = m_lexemes[lane.source];
+        const auto source = static_cast<std::uint32_t>(m_firstSource + lane.source);
+        const auto offset = static_cast<std::uint64_t>(lane.begin - lane.first);
+        if (lane.label != 0) {
+            lexemes.push_back({ lane.label, source, offset, static_cast<std::uint64_t>(lane.accept - lane.begin) });
+            restart(lane, lane.accept);
+        } else { // 无法识别时跳过一个字节，与Matcher一致
+            lexemes.push_back({ Lexeme::invalid, source, offset, 1 });
+            restart(lane, lane.begin + 1);
+        }
+        return true;
+    }
+
+    // 按顺序交付所有已经扫描完成的源文件
+    template <class Consumer>
+    void deliver(Consumer& consumer) {
+        for (; m_delivered < m_paths.size() && m_done[m_delivered]; m_delivered++) {
+            for (const auto& lexeme : m_lexemes[m_delivered]) {
+                m_batch.push(lexeme);
+                if (m_batch.full()) {
+                    consumer(m_batch);
+                    m_batch.clear();
+                }
+            }
+            m_lexemes[m_delivered] = {};
+        }
+    }
+
+private:
+    std::vector<fs::path> m_paths;
+    std::uint32_t m_firstSource;
+    std::vector<MappedFile> m_files;
+    std::vector<std::vector<Lexeme>> m_lexemes; // 各源文件尚未交付的词素
+    std::vector<bool> m_done;
+    std::vector<bool> m_failed;
+    size_t m_nextSource = 0; // 下一个待映射的源文件
+    size_t m_delivered = 0;  // 下一个待交付的源文件
+    size_t m_active = 0;     // 非空闲的通道数
+
+    std::array<Lane, Lanes> m_lanes;
+
+    TokenBatch m_batch;
+    ArrayDFA m_dfa;
+};
+
+#endif // !INTERLEAVED_SCANNER_H_
@@ -0,0 +1,22 @@
+#ifndef LEXEME_H_
+#define LEXEME_H_
+#include <cstdint>
+#include <string_view>
+
+// 非占有式的词素，只记录其在源文件中的位置，文本由扫描器按需提供
+struct Lexeme {
+    // 无法识别的词素与输入结束时的标签
+    constexpr static auto invalid = static_cast<std::uint32_t>(-1);
+
+    std::uint32_t label;
+    std::uint32_t source; // 源文件编号，即源文件在构造参数中的位置
+    std::uint64_t offset; // 词素首字节在源文件中的偏移
+    std::uint64_t length; // 词素的字节长度，词素可以长于4GiB
+
+    // 从源文件文本中截取词素
+    std::string_view view(std::string_view text) const {
+        return text.substr(static_cast<size_t>(offset), static_cast<size_t>(length));
+    }
+};
+
+#endif // !LEXEME_H_
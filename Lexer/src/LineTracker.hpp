@@ -0,0 +1,95 @@
+#ifndef LINE_TRACKER_H_
+#define LINE_TRACKER_H_
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LINE_TRACKER_SSE2
+#endif
+
+// 源文件中的位置，行与列均从1开始，列按字节计
+struct Position {
+    std::uint64_t line;
+    std::uint64_t column;
+};
+
+// 统计[first, last)中换行符的数量。
+// 向量比较的结果(-1)按字节累加，每255轮用SAD指令横向求和一次，避免字节计数溢出。
+inline size_t countNewlines(const char* first, const char* last) {
+    size_t count = 0;
+#if defined(__AVX2__)
+    const auto newline256 = _mm256_set1_epi8('\n');
+    while (last - first >= 32) {
+        auto acc = _mm256_setzero_si256();
+        const auto rounds = std::min<size_t>((last - first) / 32, 255);
+        for (size_t i = 0; i < rounds; i++, first += 32) {
+            const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+            acc = _mm256_sub_epi8(acc, _mm256_cmpeq_epi8(chunk, newline256));
+        }
+        alignas(32) std::uint64_t sums[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(sums), _mm256_sad_epu8(acc, _mm256_setzero_si256()));
+        count += static_cast<size_t>(sums[0] + sums[1] + sums[2] + sums[3]);
+    }
+#endif
+#if defined(LINE_TRACKER_SSE2)
+    const auto newline128 = _mm_set1_epi8('\n');
+    while (last - first >= 16) {
+        auto acc = _mm_setzero_si128();
+        const auto rounds = std::min<size_t>((last - first) / 16, 255);
+        for (size_t i = 0; i < rounds; i++, first += 16) {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+            acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(chunk, newline128));
+        }
+        const auto sums = _mm_sad_epu8(acc, _mm_setzero_si128());
+        count += static_cast<size_t>(_mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4));
+    }
+#endif
+    return count + static_cast<size_t>(std::count(first, last, '\n'));
+}
+
+// 按源文件偏移单调前进的行号游标，记录游标之前的换行数与当前行的起始偏移。
+// 扫描器在丢弃缓冲前让游标越过被丢弃的字节，查询时再数出游标到词素之间的换行，
+// 因此每个字节只被统计一次，列号只在查询时计算。
+class LineTracker {
+public:
+    void reset() {
+        m_offset = 0;
+        m_line = 1;
+        m_lineStart = 0;
+    }
+
+    // 游标所在的偏移，不早于此处的位置才能查询
+    std::uint64_t offset() const {
+        return m_offset;
+    }
+
+    // data为游标处的字节，将游标前进至offset
+    void advance(const char* data, std::uint64_t offset) {
+        const auto last = data + (offset - m_offset);
+        const auto lines = countNewlines(data, last);
+        if (lines != 0) {
+            m_line += lines;
+            const auto newline = std::find(std::make_reverse_iterator(last), std::make_reverse_iterator(data), '\n');
+            m_lineStart = offset - (newline - std::make_reverse_iterator(last));
+        }
+        m_offset = offset;
+    }
+
+    // data为游标处的字节，返回偏移offset处的位置
+    Position position(const char* data, std::uint64_t offset) {
+        advance(data, offset);
+        return { m_line, offset - m_lineStart + 1 };
+    }
+
+private:
+    std::uint64_t m_offset = 0;
+    std::uint64_t m_line = 1;
+    std::uint64_t m_lineStart = 0; // 游标所在行的起始偏移
+};
+
+#endif // !LINE_TRACKER_H_
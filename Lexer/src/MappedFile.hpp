@@ -0,0 +1,150 @@
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+#include <cstddef>
+#include <utility>
+#include <string_view>
+#include <filesystem>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// 只读的文件内存映射，映射的生命周期与对象绑定，不可复制
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const fs::path& path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept { swap(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            swap(other);
+        }
+        return *this;
+    }
+
+    // 映射整个文件，失败时返回false且对象保持关闭状态
+    bool open(const fs::path& path) {
+        close();
+#ifdef _WIN32
+        m_file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        if (!::GetFileSizeEx(m_file, &size)) {
+            return close(), false;
+        }
+        m_size = static_cast<size_t>(size.QuadPart);
+        if (m_size == 0) { // 空文件无法建立映射，视为打开成功的空视图
+            return m_opened = true;
+        }
+        m_mapping = ::CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping == nullptr) {
+            return close(), false;
+        }
+        m_data = static_cast<const char*>(::MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (m_data == nullptr) {
+            return close(), false;
+        }
+#else
+        m_file = ::open(path.c_str(), O_RDONLY);
+        if (m_file == -1) {
+            return false;
+        }
+        struct stat info;
+        if (::fstat(m_file, &info) != 0) {
+            return close(), false;
+        }
+        m_size = static_cast<size_t>(info.st_size);
+        if (m_size == 0) { // 空文件无法建立映射，视为打开成功的空视图
+            return m_opened = true;
+        }
+        auto addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+        if (addr == MAP_FAILED) {
+            return close(), false;
+        }
+        ::madvise(addr, m_size, MADV_SEQUENTIAL); // 提示内核按顺序预读
+        m_data = static_cast<const char*>(addr);
+#endif
+        return m_opened = true;
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (m_data != nullptr) {
+            ::UnmapViewOfFile(m_data);
+        }
+        if (m_mapping != nullptr) {
+            ::CloseHandle(m_mapping);
+        }
+        if (m_file != INVALID_HANDLE_VALUE) {
+            ::CloseHandle(m_file);
+        }
+        m_mapping = nullptr;
+        m_file = INVALID_HANDLE_VALUE;
+#else
+        if (m_data != nullptr) {
+            ::munmap(const_cast<char*>(m_data), m_size);
+        }
+        if (m_file != -1) {
+            ::close(m_file);
+        }
+        m_file = -1;
+#endif
+        m_data = nullptr;
+        m_size = 0;
+        m_opened = false;
+    }
+
+    bool isOpen() const { return m_opened; }
+
+    const char* data() const { return m_data; }
+    const char* begin() const { return m_data; }
+    const char* end() const { return m_data + m_size; }
+    size_t size() const { return m_size; }
+
+    std::string_view view() const { return { m_data, m_size }; }
+
+    void swap(MappedFile& other) noexcept {
+        std::swap(m_file, other.m_file);
+#ifdef _WIN32
+        std::swap(m_mapping, other.m_mapping);
+#endif
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_opened, other.m_opened);
+    }
+
+private:
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#else
+    int m_file = -1;
+#endif
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_opened = false;
+};
+
+#endif // !MAPPED_FILE_H_
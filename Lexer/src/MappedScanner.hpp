@@ -0,0 +1,123 @@
+#ifndef MAPPED_SCANNER_H_
+#define MAPPED_SCANNER_H_
+#include "Lexeme.hpp"
+#include "Matcher.hpp"
+#include "MappedFile.hpp"
+#include "TokenBatch.hpp"
+#include <queue>
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+
+// 基于内存映射的扫描器，整个源文件被只读映射，状态机直接在映射区域上行走。
+// 已扫描源文件的映射在扫描器析构前一直保留，故任意词素的文本都可以按需获取。
+// Linear为true时保证最坏情况下的线性扫描，见Matcher。
+template <class ArrayDFA, bool Linear = false>
+class MappedScanner {
+public:
+    // firstSource为第一个源文件的编号，供多个扫描器分担同一组源文件时使用
+    MappedScanner(std::initializer_list<fs::path> sources, std::uint32_t firstSource = 0) : m_firstSource(firstSource) {
+        for (auto& filePath : sources) {
+            m_sources.push(filePath);
+        }
+        loadSource();
+    }
+
+    Lexeme nextLexeme() {
+        // 当前源文件读尽时，切换至下一个源文件
+        while (m_begin == m_end && loadSource()) {}
+        const auto [label, length] = match();
+        const auto lexeme = Lexeme { label, currentSource(), currentOffset(), length };
+        m_begin += length;
+        return lexeme;
+    }
+
+    // 批量扫描至多max个词素并覆盖batch原有的内容，返回扫描到的词素数量，输入结束时返回0
+    size_t scan(TokenBatch& batch, size_t max) {
+        batch.clear();
+        max = std::min(max, batch.capacity());
+        while (batch.size() < max) {
+            while (m_begin == m_end && loadSource()) {}
+            const auto [label, length] = match();
+            if (length == 0) { // 输入结束
+                break;
+            }
+            batch.push(label, currentSource(), currentOffset(), length);
+            m_begin += length;
+        }
+        return batch.size();
+    }
+
+    size_t scan(TokenBatch& batch) {
+        return scan(batch, batch.capacity());
+    }
+
+    // 词素的文本视图，在扫描器析构前有效
+    std::string_view view(const Lexeme& lexeme) const {
+        const auto index = lexeme.source - m_firstSource;
+        if (index >= m_files.size()) { // 没有任何源文件时的输入结束
+            return {};
+        }
+        return lexeme.view(m_files[index].view());
+    }
+
+    // 显式复制出词素的文本
+    std::string str(const Lexeme& lexeme) const {
+        return std::string(view(lexeme));
+    }
+
+    // 打开失败的源文件编号，按扫描顺序排列。这些源文件不产生任何词素
+    const std::vector<std::uint32_t>& failures() const {
+        return m_failures;
+    }
+
+private:
+    bool loadSource() { // 映射下一个源文件，所有源文件耗尽时返回false
+        while (true) {
+            if (m_sources.empty()) {
+                m_base = m_begin = m_end = nullptr;
+                return false;
+            }
+            m_files.emplace_back(m_sources.front()); // 打开失败的源文件同样占据一个编号
+            m_sources.pop();
+            if (m_files.back().isOpen()) {
+                break;
+            }
+            m_failures.push_back(currentSource());
+        }
+        m_base = m_begin = m_files.back().begin();
+        m_matcher.reset();
+        m_end = m_files.back().end();
+        return true;
+    }
+
+    std::pair<std::uint32_t, std::uint64_t> match() {
+        return m_matcher.match(m_begin, m_end);
+    }
+
+    std::uint32_t currentSource() const {
+        return static_cast<std::uint32_t>(m_firstSource + m_files.size() - 1);
+    }
+
+    std::uint64_t currentOffset() const {
+        return static_cast<std::uint64_t>(m_begin - m_base);
+    }
+
+private:
+    // 文件映射相关成员
+    std::queue<fs::path> m_sources;
+    std::vector<MappedFile> m_files;
+    std::vector<std::uint32_t> m_failures;
+    std::uint32_t m_firstSource;
+
+    // 扫描位置相关成员
+    const char* m_base = nullptr; // 当前源文件映射的起始位置
+    const char* m_begin = nullptr;
+    const char* m_end = nullptr;
+
+    // 状态机相关成员
+    Matcher<ArrayDFA, Linear> m_matcher;
+};
+
+#endif // !MAPPED_SCANNER_H_
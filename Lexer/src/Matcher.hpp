@@ -0,0 +1,161 @@
+#ifndef MATCHER_H_
+#define MATCHER_H_
+#include "Lexeme.hpp"
+#include "FailureMemo.hpp"
+#include "SelfLoop.hpp"
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
+
+// 在一段连续内存上做最长匹配的核心，为基于内存的各种扫描器所共用。
+// Linear为true时记录回溯中失败的(状态, 位置)对，保证最长匹配在最坏情况下也是线性的。
+// 状态机无需回溯(ArrayDFA::backtrack_free)时改用不带状态栈的匹配循环，Linear随之失去意义。
+// 进入自环状态时成段跳过自环的字节，见SelfLoop。
+// 后端提供run(state, first, last)时（如cp::shuffle_dfa），无需回溯的匹配循环交给它连续转换。
+template <class ArrayDFA, bool Linear = false>
+class Matcher {
+public:
+    // 切换到另一段内存前调用，丢弃失败记录
+    void reset() {
+        if constexpr (Linear) {
+            m_memo.reset(0);
+        }
+    }
+
+    // 上一次匹配检查过的字节数，包括使状态机停下的字符，到达last也计为检查了一个字节。
+    // 匹配结果只取决于这些字节，其后的内容改变不会影响它；Linear为true时提前停止会使其偏小。
+    std::uint64_t examined() const {
+        return m_examined;
+    }
+
+    // 从first开始匹配最长的词素，返回其标签与长度，长度为0代表first == last。
+    // 无法识别时返回invalid标签与长度1，以保证扫描能继续前进。
+    std::pair<std::uint32_t, std::uint64_t> match(const char* first, const char* last) {
+        if constexpr (ArrayDFA::backtrack_free) {
+            return matchStackless(first, last);
+        } else {
+            return matchBacktrack(first, last);
+        }
+    }
+
+private:
+    using Skip = SelfLoop<ArrayDFA>;
+
+    template <class DFA, class = void>
+    struct HasRun : std::false_type {};
+
+    template <class DFA>
+    struct HasRun<DFA, std::void_t<decltype(DFA::run(std::declval<int&>(), nullptr, nullptr))>> : std::true_type {};
+
+    // 无需回溯的状态机：接受之后可达的非空状态都是接受状态，停下时的状态便决定了词素，
+    // 前进时既不保存状态栈，也不逐字节查询标签，停下后只查询一次。
+    // 这样的状态机本身不会退化为二次复杂度，因此也无需失败记录。
+    std::pair<std::uint32_t, std::uint64_t> matchStackless(const char* first, const char* last) {
+        int state = m_dfa.initial_state;
+        auto forward = first;
+        if constexpr (HasRun<ArrayDFA>::value) {
+            while (true) { // run在空状态、last或刚进入自环状态时停下，只有最后一种需要跳过后继续
+                const auto stop = ArrayDFA::run(state, forward, last);
+                if (stop == forward) {
+                    break;
+                }
+                forward = stop;
+                if constexpr (Skip::enabled) {
+                    if (Skip::loops(state)) {
+                        forward = Skip::skip(state, forward, last);
+                        continue;
+                    }
+                }
+                break;
+            }
+        } else {
+            while (forward != last) {
+                const auto nextState = m_dfa.trans(state, *forward);
+                if (nextState == m_dfa.null_state) {
+                    break;
+                }
+                ++forward;
+                if constexpr (Skip::enabled) {
+                    if (Skip::loops(nextState)) { // 进入自环状态后，之后的自环字节都被一并跳过
+                        forward = Skip::skip(nextState, forward, last);
+                    }
+                }
+                state = nextState;
+            }
+        }
+        m_examined = static_cast<std::uint64_t>(forward - first + 1);
+        if (const auto label = m_dfa.label(state); label != 0 && forward != first) {
+            return { label, static_cast<std::uint64_t>(forward - first) };
+        }
+        return { Lexeme::invalid, first == last ? 0 : 1 };
+    }
+
+    // 状态栈每项是一段连续处于同一状态的位置，自环成段跳过时只占一项，回溯时整段退回。
+    // 段内各位置的状态相同，若该状态不接受，段内任何位置都不接受，故只需检查每段的末尾
+    std::pair<std::uint32_t, std::uint64_t> matchBacktrack(const char* first, const char* last) {
+        if constexpr (Linear) {
+            m_memo.advance(position(first));
+        }
+        // Initialize stack with initial state
+        m_stateStack.resize(1, { m_dfa.initial_state, 0 });
+        // forwarding
+        auto forward = first;
+        while (forward != last) {
+            if constexpr (Linear) {
+                if (m_memo.template failed<ArrayDFA>(m_stateStack.back().state, position(forward))) { // 从这里出发已知不会再接受
+                    break;
+                }
+            }
+            const auto nextState = m_dfa.trans(m_stateStack.back().state, *forward);
+            if (nextState == m_dfa.null_state) {
+                break;
+            }
+            m_stateStack.push_back({ nextState, 1 });
+            ++forward;
+            if constexpr (Skip::enabled) {
+                if (Skip::loops(nextState)) {
+                    if constexpr (Linear) {
+                        if (m_memo.template failed<ArrayDFA>(nextState, position(forward))) { // 落在已失败的段内，无需再跳过
+                            break;
+                        }
+                    }
+                    const auto end = Skip::skip(nextState, forward, last);
+                    m_stateStack.back().length += end - forward;
+                    forward = end;
+                }
+            }
+        }
+        m_examined = static_cast<std::uint64_t>(forward - first + 1);
+        // backtracking
+        while (m_stateStack.size() > 1) {
+            const auto [state, length] = m_stateStack.back();
+            const auto label = m_dfa.label(state);
+            if (label != 0) {
+                return { label, static_cast<std::uint64_t>(forward - first) };
+            }
+            if constexpr (Linear) {
+                m_memo.template fail<ArrayDFA>(state, length, position(forward));
+            }
+            m_stateStack.pop_back();
+            forward -= length;
+        }
+        return { Lexeme::invalid, first == last ? 0 : 1 };
+    }
+
+    static std::uint64_t position(const char* p) {
+        return reinterpret_cast<std::uintptr_t>(p);
+    }
+
+    struct Run {
+        int state;
+        std::uint64_t length; // 连续处于该状态的位置数
+    };
+
+    ArrayDFA m_dfa;
+    std::vector<Run> m_stateStack;
+    std::uint64_t m_examined = 0;
+    FailureMemo<ArrayDFA::states_size + 1> m_memo;
+};
+
+#endif // !MATCHER_H_
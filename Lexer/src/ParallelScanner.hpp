@@ -0,0 +1,77 @@
+#ifndef PARALLEL_SCANNER_H_
+#define PARALLEL_SCANNER_H_
+#include "MappedScanner.hpp"
+#include "ThreadPool.hpp"
+#include <future>
+#include <memory>
+#include <vector>
+
+// 多文件并行扫描器：各源文件作为独立任务分发到工作窃取线程池中扫描，
+// 扫描结果仍按源文件在构造参数中的顺序依次交给使用者。
+template <class ArrayDFA, bool Linear = false>
+class ParallelScanner {
+public:
+    // 单个源文件的扫描结果，持有该源文件的扫描器以便按需获取词素文本
+    class SourceTokens {
+    public:
+        SourceTokens(const fs::path& path, std::uint32_t source) : m_source(source), m_scanner({ path }, source) {
+            TokenBatch batch;
+            while (m_scanner.scan(batch)) {
+                m_batches.push_back(batch);
+            }
+        }
+
+        std::uint32_t source() const { return m_source; }
+        bool opened() const { return m_scanner.failures().empty(); } // 打开失败的源文件没有词素
+        const std::vector<TokenBatch>& batches() const { return m_batches; }
+
+        std::string_view view(const Lexeme& lexeme) const { return m_scanner.view(lexeme); }
+        std::string str(const Lexeme& lexeme) const { return m_scanner.str(lexeme); }
+
+    private:
+        std::uint32_t m_source;
+        MappedScanner<ArrayDFA, Linear> m_scanner;
+        std::vector<TokenBatch> m_batches;
+    };
+
+    ParallelScanner(std::initializer_list<fs::path> sources, size_t threads = ThreadPool::defaultThreads())
+        : m_sources(sources), m_threads(threads) {}
+
+    // 并行扫描所有源文件，并按源文件的原有顺序依次调用consumer(const SourceTokens&)。
+    // 同时在途的源文件数量有上限，以免交付滞后时扫描结果堆积过多。
+    template <class Consumer>
+    void run(Consumer&& consumer) {
+        ThreadPool pool(m_threads);
+        const auto window = pool.size() * 4;
+        std::vector<std::future<std::unique_ptr<SourceTokens>>> results(m_sources.size());
+
+        auto submit = [&](size_t i) {
+            auto promise = std::make_shared<std::promise<std::unique_ptr<SourceTokens>>>();
+            results[i] = promise->get_future();
+            pool.submit([promise, path = m_sources[i], i] {
+                try {
+                    promise->set_value(std::make_unique<SourceTokens>(path, static_cast<std::uint32_t>(i)));
+                } catch (...) {
+                    promise->set_exception(std::current_exception());
+                }
+            });
+        };
+
+        for (size_t i = 0; i < std::min(window, m_sources.size()); i++) {
+            submit(i);
+        }
+        for (size_t i = 0; i < m_sources.size(); i++) {
+            const auto tokens = results[i].get(); // 按顺序等待，之后的源文件可能早已扫描完成
+            if (i + window < m_sources.size()) {
+                submit(i + window);
+            }
+            consumer(*tokens);
+        }
+    }
+
+private:
+    std::vector<fs::path> m_sources;
+    size_t m_threads;
+};
+
+#endif // !PARALLEL_SCANNER_H_
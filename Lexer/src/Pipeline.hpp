@@ -0,0 +1,112 @@
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+#include "Lexeme.hpp"
+#include "TokenBatch.hpp"
+#include "SpscRing.hpp"
+#include <string>
+#include <vector>
+#include <thread>
+#include <utility>
+#include <exception>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// 扫描与解析流水线：扫描器在独立的线程中运行，按批将词素发布到单生产者单消费者环形队列，
+// 解析等下游阶段在使用者的线程中消费，两者在不同的核心上重叠进行。
+// 每批词素只需一次跨线程交接；队列满时扫描线程等待下游，扫描结束时下游得到空批次。
+// Text为true时随批次复制词素的文本，供Scanner这类只保留最近一个词素文本的扫描器使用，
+// 此时扫描线程逐个取出词素；MappedScanner等文本一直有效的扫描器无需复制。
+template <class Scanner, bool Text = false, size_t Depth = 8>
+class Pipeline {
+public:
+    struct Batch {
+        TokenBatch tokens;
+        std::string text;                 // Text为true时各词素文本的拼接
+        std::vector<size_t> starts;       // 各词素文本在text中的起始位置
+
+        std::string_view view(size_t i) const {
+            return std::string_view(text).substr(starts[i], static_cast<size_t>(tokens.lengths()[i]));
+        }
+    };
+
+    // 用sources与其余参数构造扫描器并启动扫描线程
+    template <class... Args>
+    explicit Pipeline(std::initializer_list<fs::path> sources, Args&&... args)
+        : m_scanner(sources, std::forward<Args>(args)...) {
+        m_thread = std::thread([this] { produce(); });
+    }
+
+    ~Pipeline() {
+        m_ring.cancel();
+        m_thread.join();
+    }
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    // 取得下一批词素，上一次取得的批次随之归还；扫描结束时返回nullptr，扫描中的异常在此抛出
+    const Batch* next() {
+        if (m_holding) {
+            m_ring.release();
+        }
+        const auto batch = m_ring.front();
+        m_holding = batch != nullptr;
+        if (batch == nullptr && m_error) {
+            std::rethrow_exception(std::exchange(m_error, nullptr));
+        }
+        return batch;
+    }
+
+    // 依次将各批词素交给consumer(const Batch&)
+    template <class Consumer>
+    void run(Consumer&& consumer) {
+        while (const auto batch = next()) {
+            consumer(*batch);
+        }
+    }
+
+private:
+    void produce() { // 扫描线程
+        try {
+            while (const auto batch = m_ring.acquire()) {
+                if (fill(*batch) == 0) {
+                    break;
+                }
+                m_ring.publish();
+            }
+        } catch (...) {
+            m_error = std::current_exception(); // 关闭队列的释放语义使消费者能看到它
+        }
+        m_ring.close();
+    }
+
+    size_t fill(Batch& batch) {
+        if constexpr (Text) {
+            batch.tokens.clear();
+            batch.text.clear();
+            batch.starts.clear();
+            while (!batch.tokens.full()) {
+                const auto lexeme = m_scanner.nextLexeme();
+                if (lexeme.length == 0) { // 输入结束
+                    break;
+                }
+                batch.tokens.push(lexeme);
+                batch.starts.push_back(batch.text.size());
+                batch.text += m_scanner.view(lexeme);
+            }
+            return batch.tokens.size();
+        } else {
+            return m_scanner.scan(batch.tokens);
+        }
+    }
+
+private:
+    Scanner m_scanner;
+    SpscRing<Batch, Depth> m_ring;
+    std::exception_ptr m_error;
+    bool m_holding = false; // 消费者是否持有一个尚未归还的批次
+    std::thread m_thread;
+};
+
+#endif // !PIPELINE_H_
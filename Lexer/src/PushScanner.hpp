@@ -0,0 +1,202 @@
+#ifndef PUSH_SCANNER_H_
+#define PUSH_SCANNER_H_
+#include "Lexeme.hpp"
+#include "FailureMemo.hpp"
+#include "SelfLoop.hpp"
+#include "TokenBatch.hpp"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+
+// 推送式扫描器，输入由使用者分段送入，适用于数据陆续到达的管道、套接字与异步读取。
+// 每送入一段数据便扫描出其中已经确定的词素；匹配检查到了数据末尾的词素还可能被之后的数据延长，
+// 于是扫描在此挂起，保留未完成的字节与匹配的进度(状态机的状态与状态栈)，
+// 下一段数据到达时只从新到的字节继续前进，逐字节送入也不会重复检查已经看过的字节。
+// 挂起时不占用调用栈，因此扫描与解析可以在同一个事件循环中交替进行。
+// Linear为true时保证最坏情况下的线性扫描，见Matcher。
+template <class ArrayDFA, bool Linear = false>
+class PushScanner {
+public:
+    explicit PushScanner(std::uint32_t source = 0) : m_source(source) {
+        restart();
+    }
+
+    // 送入一段数据，按批将已经确定的词素交给consumer(const TokenBatch&)
+    template <class Consumer>
+    void feed(std::string_view data, Consumer&& consumer) {
+        m_buffer.append(data.data(), data.size());
+        scan(false, consumer);
+    }
+
+    // 输入结束，交付剩余的词素
+    template <class Consumer>
+    void finish(Consumer&& consumer) {
+        scan(true, consumer);
+    }
+
+    // 词素的文本视图，只在交付该词素的consumer调用期间有效
+    std::string_view view(const Lexeme& lexeme) const {
+        if (lexeme.source != m_source || lexeme.offset < m_offset || lexeme.offset + lexeme.length > m_offset + m_buffer.size()) {
+            throw std::invalid_argument("lexeme is no longer buffered");
+        }
+        return std::string_view(m_buffer).substr(static_cast<size_t>(lexeme.offset - m_offset), static_cast<size_t>(lexeme.length));
+    }
+
+    std::string str(const Lexeme& lexeme) const {
+        return std::string(view(lexeme));
+    }
+
+private:
+    using Skip = SelfLoop<ArrayDFA>;
+
+    template <class Consumer>
+    void scan(bool last, Consumer& consumer) {
+        while (m_begin != m_buffer.size()) {
+            if (!advance() && !last) { // 匹配到达了数据末尾，等待更多数据
+                break;
+            }
+            const auto [label, length] = resolve();
+            m_batch.push(label, m_source, m_offset + m_begin, length);
+            if (m_batch.full()) {
+                consumer(m_batch);
+                m_batch.clear();
+            }
+            m_begin += static_cast<size_t>(length);
+            restart();
+        }
+        if (!m_batch.empty()) {
+            consumer(m_batch);
+            m_batch.clear();
+        }
+        if (m_begin * 2 >= m_buffer.size()) { // 已确定的前缀过半时才整理，保证均摊代价为常数
+            m_buffer.erase(0, m_begin);
+            m_offset += m_begin;
+            m_forward -= m_begin;
+            m_begin = 0;
+        }
+    }
+
+    void restart() { // 从m_begin开始匹配下一个词素
+        m_forward = m_begin;
+        if constexpr (ArrayDFA::backtrack_free) {
+            m_state = m_dfa.initial_state;
+        } else {
+            m_stateStack.resize(1, { m_dfa.initial_state, 0 });
+            if constexpr (Linear) {
+                m_memo.advance(m_offset + m_begin);
+            }
+        }
+    }
+
+    // 从m_forward继续前进，状态机停下时返回true，到达数据末尾时返回false。
+    // 状态栈每项是一段连续处于同一状态的位置，见Matcher；被数据末尾打断的自环段在继续时接续到栈顶
+    bool advance() {
+        const char* const data = m_buffer.data();
+        const auto end = data + m_buffer.size();
+        auto forward = data + m_forward;
+        auto stopped = false;
+        if constexpr (ArrayDFA::backtrack_free) {
+            while (forward != end) {
+                const auto nextState = m_dfa.trans(m_state, *forward);
+                if (nextState == m_dfa.null_state) {
+                    stopped = true;
+                    break;
+                }
+                ++forward;
+                if constexpr (Skip::enabled) {
+                    if (Skip::loops(nextState)) {
+                        forward = Skip::skip(nextState, forward, end);
+                    }
+                }
+                m_state = nextState;
+            }
+        } else {
+            while (forward != end) {
+                if constexpr (Linear) {
+                    if (m_memo.template failed<ArrayDFA>(m_stateStack.back().state, offsetOf(forward))) { // 从这里出发已知不会再接受
+                        stopped = true;
+                        break;
+                    }
+                }
+                const auto nextState = m_dfa.trans(m_stateStack.back().state, *forward);
+                if (nextState == m_dfa.null_state) {
+                    stopped = true;
+                    break;
+                }
+                ++forward;
+                if constexpr (Skip::enabled) {
+                    if (Skip::loops(nextState)) {
+                        if (nextState == m_stateStack.back().state) {
+                            m_stateStack.back().length += 1;
+                        } else {
+                            m_stateStack.push_back({ nextState, 1 });
+                            if constexpr (Linear) {
+                                if (m_memo.template failed<ArrayDFA>(nextState, offsetOf(forward))) { // 落在已失败的段内，无需再跳过
+                                    stopped = true;
+                                    break;
+                                }
+                            }
+                        }
+                        const auto skipped = Skip::skip(nextState, forward, end);
+                        m_stateStack.back().length += skipped - forward;
+                        forward = skipped;
+                        continue;
+                    }
+                }
+                m_stateStack.push_back({ nextState, 1 });
+            }
+        }
+        m_forward = static_cast<size_t>(forward - data);
+        return stopped;
+    }
+
+    // 前进结束后确定从m_begin开始的词素，无法识别时返回invalid标签与长度1
+    std::pair<std::uint32_t, std::uint64_t> resolve() {
+        if constexpr (ArrayDFA::backtrack_free) { // 停下时的状态便决定了词素，见Matcher
+            if (const auto label = m_dfa.label(m_state); label != 0 && m_forward != m_begin) {
+                return { label, static_cast<std::uint64_t>(m_forward - m_begin) };
+            }
+        } else {
+            auto forward = m_forward;
+            while (m_stateStack.size() > 1) {
+                const auto [state, length] = m_stateStack.back();
+                const auto label = m_dfa.label(state);
+                if (label != 0) {
+                    return { label, static_cast<std::uint64_t>(forward - m_begin) };
+                }
+                if constexpr (Linear) {
+                    m_memo.template fail<ArrayDFA>(state, length, m_offset + forward);
+                }
+                m_stateStack.pop_back();
+                forward -= static_cast<size_t>(length);
+            }
+        }
+        return { Lexeme::invalid, 1 };
+    }
+
+    std::uint64_t offsetOf(const char* p) const { // 缓冲中的位置在输入中的偏移，整理缓冲后不变
+        return m_offset + static_cast<std::uint64_t>(p - m_buffer.data());
+    }
+
+private:
+    struct Run {
+        int state;
+        std::uint64_t length; // 连续处于该状态的位置数
+    };
+
+    std::uint32_t m_source;
+    std::string m_buffer;       // 尚未整理掉的字节
+    std::uint64_t m_offset = 0; // m_buffer首字节在输入中的偏移
+    size_t m_begin = 0;         // 当前词素在m_buffer中的起点，之前的字节都已确定
+    size_t m_forward = 0;       // 当前词素下一个要检查的字节
+    TokenBatch m_batch;
+
+    // 状态机相关成员，挂起时保存匹配的进度
+    ArrayDFA m_dfa;
+    int m_state = 0;            // 无需回溯的状态机的当前状态
+    std::vector<Run> m_stateStack;
+    FailureMemo<ArrayDFA::states_size + 1> m_memo;
+};
+
+#endif // !PUSH_SCANNER_H_
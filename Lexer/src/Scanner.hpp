@@ -1,145 +1,584 @@
 #ifndef SCANNER_H_
 #define SCANNER_H_
+#include "Lexeme.hpp"
+#include "TokenBatch.hpp"
+#include "FailureMemo.hpp"
+#include "LineTracker.hpp"
+#include "SelfLoop.hpp"
+#include "SymbolTable.hpp"
 #include <array>
 #include <queue>
+#include <vector>
+#include <string>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
 #include <fstream>
 #include <filesystem>
+#include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 namespace fs = std::filesystem;
 
-struct Lexeme {
-    std::uint32_t label;
-    std::string data;
+// ScannerѡԱǩͰ˳δѡرգScanner<DFA, N, scan::Prefetch, scan::Interned<1>>
+namespace scan {
+// ̨I/O߳״̬ĵǰͬʱȡÿ飬ʹȡɨص
+struct Prefetch {};
+// ¼ʧܵ(״̬, λ)ԣ֤ƥҲԵ
+struct Linear {};
+// кţԲѯصλãʱκο
+struct Positions {};
+// ҪפĴرǩֻͨбʶ
+template <std::uint32_t... Labels>
+struct Interned {
+    constexpr static bool contains(std::uint32_t label) {
+        return ((label == Labels) || ...);
+    }
+};
+
+template <class Option>
+constexpr bool isInterned = false;
+template <std::uint32_t... Labels>
+constexpr bool isInterned<Interned<Labels...>> = true;
+
+template <class Option, class... Options>
+constexpr bool has = (std::is_same_v<Option, Options> || ...);
+
+// ѡеInternedûиʱΪInterned<>
+template <class... Options>
+struct InternedOf {
+    using type = Interned<>;
+};
+template <std::uint32_t... Labels, class... Options>
+struct InternedOf<Interned<Labels...>, Options...> {
+    using type = Interned<Labels...>;
 };
+template <class Option, class... Options>
+struct InternedOf<Option, Options...> : InternedOf<Options...> {};
+}
 
-template <class ArrayDFA, size_t N>
+// ʽɨȡԴļOptionsΪscanеѡ
+// scan::Prefetch̨I/O̶߳ȡÿ顣
+// scan::Linear¼еʧܣ״̬(ArrayDFA::backtrack_free)ʱò״̬ջƥѭѡ֮ʧȥ塣
+// Ի״̬ʱɶԻֽڣSelfLoop
+// scan::Positionsкţposition
+// scan::Internedǿʱ״̬ߵͬʱЩصɢֵ
+// ԽפűжٴαıֻпܳΪЩصǰ׺żɢֵmarkInterned
+template <class ArrayDFA, size_t N, class... Options>
 class Scanner {
 public:
-    using Buffer = std::array<char, N + 1>;   // ַ壬һλΪڱEOF
-    using DualBuffer = std::array<Buffer, 2>; // ˫
+    // ĲΪ[][][ڱ]ʱδɵĴرƵ¿ıĩβ
+    // ʹǰģسڱʱӱʴسȲܿСơ
+    using Block = std::vector<char>;
 
-    // ˫ĵ
-    class BufferIter : std::iterator_traits<char*> {
-    public:
-        BufferIter(Scanner& scanner, Buffer::iterator iter) : m_scanner(scanner), m_iter(iter) {}
-        BufferIter(const BufferIter& other) : BufferIter(other.m_scanner, other.m_iter) {}
+    // ״̬ڱַȻ״̬ǰʱֻһο״̬
+    // ֻڿ״̬ǡóĩβʱҪ飬гֵͬһֽڲӰ졣
+    // ״ַֽ̬ڣ˻Ϊʽı߽顣
+    constexpr static bool hasSentinel = ArrayDFA::sentinel >= 0;
+    constexpr static char sentinel = hasSentinel ? static_cast<char>(ArrayDFA::sentinel) : '\0';
 
-        char operator*() const { return *m_iter; }
+    using Skip = SelfLoop<ArrayDFA>;
 
-        BufferIter& operator++() { return ++m_iter, moveBufferIfEnd(); }
-        BufferIter& operator--() { return --m_iter, moveBufferIfEnd(); }
-        BufferIter  operator++(int) { auto tmp = *this; ++(*this); return tmp; }
-        BufferIter  operator--(int) { auto tmp = *this; --(*this); return tmp; }
+    static_assert(((scan::has<Options, scan::Prefetch, scan::Linear, scan::Positions> || scan::isInterned<Options>) && ...),
+        "unknown Scanner option");
+    constexpr static bool prefetching = scan::has<scan::Prefetch, Options...>;
+    constexpr static bool linear = scan::has<scan::Linear, Options...>;
+    constexpr static bool tracking = scan::has<scan::Positions, Options...>;
+    using Interned = typename scan::InternedOf<Options...>::type;
+    constexpr static bool interning = !std::is_same_v<Interned, scan::Interned<>>;
 
-        bool operator==(const BufferIter& other) const { return m_iter == other.m_iter; }
-        bool operator!=(const BufferIter& other) const { return m_iter != other.m_iter; }
+    Scanner(std::initializer_list<fs::path> sources) : m_reserve(N) {
+        for (auto& filePath : sources) {
+            m_sources.push(filePath);
+        }
+        for (auto& block : m_blocks) {
+            block.resize(m_reserve + N + 1);
+        }
+        if constexpr (interning) {
+            markInterned();
+        }
+        if constexpr (prefetching) {
+            m_ioThread = std::thread([this] { ioLoop(); });
+        }
+        loadSource();
+    }
 
-        BufferIter& operator=(BufferIter other) {
-            if (&m_scanner == &other.m_scanner) {
-                m_iter = other.m_iter;
-            } else {
-                throw std::invalid_argument("must in in same scanner");
+    ~Scanner() {
+        if constexpr (prefetching) {
+            {
+                std::lock_guard<std::mutex> lock(m_ioMutex);
+                m_ioStop = true;
             }
-            return *this;
+            m_ioCond.notify_all();
+            m_ioThread.join();
         }
+    }
+
+    Scanner(const Scanner&) = delete;
+    Scanner& operator=(const Scanner&) = delete;
+
+    Lexeme nextLexeme() {
+        // ǰԴļʱлһԴļ
+        while (sourceExhausted() && loadSource()) {}
+        const auto [label, length] = match();
+        const auto lexeme = Lexeme { label, m_sourceIndex, m_offset, length };
+        consume(length);
+        return lexeme;
+    }
 
-    private:
-        BufferIter& moveBufferIfEnd() {
-            if (*m_iter == EOF) {
-                m_scanner.m_bufferIndex += 1;
-                m_scanner.m_bufferIndex %= m_scanner.m_buffer.size();
-                m_scanner.loadBuffer();
-                m_iter = m_scanner.currentBuffer().begin();
+    // ɨmaxزbatchԭеݣɨ赽Ĵʱ0
+    size_t scan(TokenBatch& batch, size_t max) {
+        batch.clear();
+        max = std::min(max, batch.capacity());
+        while (batch.size() < max) {
+            while (sourceExhausted() && loadSource()) {}
+            const auto [label, length] = match();
+            if (length == 0) { // 
+                break;
             }
-            return *this;
+            batch.push(label, m_sourceIndex, m_offset, length);
+            consume(length);
         }
+        return batch.size();
+    }
 
-        Scanner& m_scanner;
-        Buffer::iterator m_iter;
-    };
+    size_t scan(TokenBatch& batch) {
+        return scan(batch, batch.capacity());
+    }
 
-    Scanner(std::initializer_list<fs::path> sources)
-        : m_buffer(), 
-        m_begin(*this, m_buffer[0].begin()), 
-        m_forward(*this, m_buffer[0].begin()), 
-        m_bufferIndex(0) 
-    {
-        for (auto& filePath : sources) {
-            m_sources.push(filePath);
+    // صıͼֻһηصĴڻУͼһɨǰЧ
+    std::string_view view(const Lexeme& lexeme) const {
+        if (lexeme.source != m_sourceIndex || lexeme.offset + lexeme.length != m_offset) {
+            throw std::invalid_argument("lexeme is no longer buffered");
         }
-        for (auto& buffer : m_buffer) {
-            buffer.fill(EOF);
+        return { m_lexeme, static_cast<size_t>(lexeme.length) };
+    }
+
+    // ʽƳصı
+    std::string str(const Lexeme& lexeme) const {
+        return std::string(view(lexeme));
+    }
+
+    // λáѯ밴λ˳УҴڻУ
+    // һηصĴǿԲѯ
+    Position position(const Lexeme& lexeme) {
+        static_assert(tracking, "position tracking is disabled");
+        if (lexeme.source != m_sourceIndex || lexeme.offset < m_lines.offset() || lexeme.offset > m_offset) {
+            throw std::invalid_argument("lexeme is no longer buffered");
         }
-        loadBuffer();
+        return m_lines.position(bufferAt(m_lines.offset()), lexeme.offset);
     }
 
-    Buffer& currentBuffer() {
-        return m_buffer[m_bufferIndex];
+    // һηصĴפűУű
+    SymbolTable::Symbol symbol(const Lexeme& lexeme) {
+        static_assert(interning, "interning is disabled");
+        const auto text = view(lexeme);
+        if (!interned(lexeme.label)) { // ɨʱֻΪInternedеıǩɢֵ
+            return m_symbols.intern(text);
+        }
+        return m_symbols.intern(text, m_hash);
     }
 
-    Lexeme nextLexeme() {
+    const SymbolTable& symbols() const {
+        return m_symbols;
+    }
+
+    // ʧܵԴļţɨ˳СЩԴļκδ
+    const std::vector<std::uint32_t>& failures() const {
+        return m_failures;
+    }
+
+private:
+    bool loadSource() { // һԴļȡ׸ļ飬Դļľʱfalse
+        while (true) {
+            if (m_sources.empty()) {
+                return false;
+            }
+            m_curFile.open(m_sources.front(), std::ios::binary);
+            m_sources.pop();
+            m_sourceIndex += 1; // ʧܵԴļͬռһ
+            if (m_curFile.is_open()) {
+                break;
+            }
+            m_failures.push_back(m_sourceIndex);
+        }
+        auto& block = m_blocks[m_active];
+        m_begin = m_forward = &block[m_reserve];
+        m_limit = m_begin + loadBlock(m_begin);
+        *m_limit = sentinel;
+        m_lexeme = m_begin;
+        m_offset = 0;
+        if constexpr (linear) {
+            m_memo.reset(0);
+        }
+        if constexpr (tracking) {
+            m_lines.reset();
+        }
+        if constexpr (prefetching) {
+            prefetch(&m_blocks[1 - m_active][m_reserve]);
+        }
+        return true;
+    }
+
+    size_t loadBlock(char* data) { // ȡµļָλãضȡֽ
+        if (!m_curFile.is_open()) {
+            return 0;
+        }
+        m_curFile.read(data, N);
+        const auto count = static_cast<size_t>(m_curFile.gcount());
+        if (m_curFile.eof()) {
+            m_curFile.close();
+        }
+        return count;
+    }
+
+    bool refill() { // ǰʱ뱸ÿ飬falseǰԴļѶ
+        auto& spare = m_blocks[1 - m_active];
+        const auto count = prefetching && m_ioPending ? waitPrefetch() : loadBlock(&spare[m_reserve]);
+        if (count == 0) {
+            return false;
+        }
+        if constexpr (tracking) { // кαԽֽ
+            m_lines.advance(bufferAt(m_lines.offset()), m_offset);
+        }
+        // δɵĴأ֤¿
+        const auto retained = static_cast<size_t>(m_limit - m_begin);
+        if (retained > m_reserve) { // ĳأӱŲÿ
+            const auto reserve = std::max(retained, m_reserve * 2);
+            Block grown(reserve + N + 1);
+            std::copy_n(&spare[m_reserve], count, &grown[reserve]);
+            spare.swap(grown);
+            m_reserve = reserve;
+        }
+        const auto begin = &spare[m_reserve - retained];
+        std::copy(m_begin, m_limit, begin);
+        m_forward = begin + (m_forward - m_begin);
+        m_begin = begin;
+        m_limit = &spare[m_reserve] + count;
+        *m_limit = sentinel;
+        m_active = 1 - m_active;
+        // ԭĿΪµıÿ飬ͬ
+        auto& free = m_blocks[1 - m_active];
+        if (free.size() < m_reserve + N + 1) {
+            free.resize(m_reserve + N + 1);
+        }
+        if constexpr (prefetching) {
+            prefetch(&free[m_reserve]);
+        }
+        return true;
+    }
+
+    bool sourceExhausted() { // ǰԴļݶѱɨ
+        return m_forward == m_limit && !refill();
+    }
+
+    void prefetch(char* data) { // ں̨ȡÿ
+        if (!m_curFile.is_open()) { // ûнеԤʱŻļ
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_ioMutex);
+            m_ioData = data;
+            m_ioCount = 0;
+        }
+        m_ioPending = true;
+        m_ioCond.notify_all();
+    }
+
+    size_t waitPrefetch() {
+        std::unique_lock<std::mutex> lock(m_ioMutex);
+        m_ioCond.wait(lock, [this] { return m_ioData == nullptr; });
+        m_ioPending = false;
+        return m_ioCount;
+    }
+
+    void ioLoop() { // ̨I/Ọ߳ÿδһȡ
+        std::unique_lock<std::mutex> lock(m_ioMutex);
+        while (true) {
+            m_ioCond.wait(lock, [this] { return m_ioData != nullptr || m_ioStop; });
+            if (m_ioData == nullptr) {
+                return;
+            }
+            const auto data = m_ioData;
+            lock.unlock();
+            const auto count = loadBlock(data);
+            lock.lock();
+            m_ioCount = count;
+            m_ioData = nullptr;
+            m_ioCond.notify_all();
+        }
+    }
+
+    // m_beginʼƥĴأǩ볤ȣΪ0
+    std::pair<std::uint32_t, std::uint64_t> match() {
+        if constexpr (ArrayDFA::backtrack_free) {
+            return matchStackless();
+        } else {
+            return matchBacktrack();
+        }
+    }
+
+    // ݵ״̬֮ɴķǿ״̬ǽ״̬ͣʱ״̬˴أ
+    // ǰʱȲ״̬ջҲֽڲѯǩͣºֻѯһΡ
+    // ״̬˻ΪθӶȣҲʧܼ¼
+    std::pair<std::uint32_t, std::uint64_t> matchStackless() {
+        auto state = m_dfa.initial_state;
+        auto hash = SymbolTable::seed;
+        while (true) {
+            if constexpr (!hasSentinel) {
+                if (m_forward == m_limit && !refill()) {
+                    break;
+                }
+            }
+            const auto nextState = m_dfa.trans(state, *m_forward);
+            if (nextState == m_dfa.null_state) {
+                if constexpr (hasSentinel) {
+                    if (m_forward == m_limit && refill()) { // ڱǰ
+                        continue;
+                    }
+                }
+                break;
+            }
+            state = nextState;
+            ++m_forward;
+            if constexpr (interning) {
+                if (hashes(state)) {
+                    hash = SymbolTable::step(hash, m_forward[-1]);
+                }
+            }
+            if constexpr (Skip::enabled) {
+                if (Skip::loops(state)) { // Ի״̬ɶĩʱ
+                    const auto skipped = Skip::skip(state, m_forward, m_limit) - m_forward;
+                    if constexpr (interning) {
+                        if (hashes(state)) {
+                            hash = SymbolTable::extend(hash, { m_forward, static_cast<size_t>(skipped) });
+                        }
+                    }
+                    m_forward += skipped;
+                }
+            }
+        }
+        const auto length = static_cast<std::uint64_t>(m_forward - m_begin);
+        if (const auto label = m_dfa.label(state); label != 0 && length != 0) {
+            m_hash = hash;
+            return { label, length };
+        }
+        m_forward = m_begin;
+        return skipInvalid();
+    }
+
+    // ״̬ջÿһͬһ״̬λãԻɶʱֻռһʱ˻أMatcher
+    // ͣµλǰʱһܵλãɢֵֻڽפǩʱһ
+    std::pair<std::uint32_t, std::uint64_t> matchBacktrack() {
+        if constexpr (linear) {
+            m_memo.advance(m_offset);
+        }
         // Initialize stack with initial state
-        m_stateStack.resize(1, m_dfa.initial_state);
+        m_stateStack.resize(1, { m_dfa.initial_state, 0 });
+        auto hash = SymbolTable::seed;
+        auto acceptHash = SymbolTable::seed;
         // forwarding
         while (true) {
-            const auto state = m_stateStack.back();
-            const auto nextChar = *(++m_forward);
-            if (nextChar == EOF) {
-                break;
+            if constexpr (!hasSentinel) {
+                if (m_forward == m_limit && !refill()) {
+                    break;
+                }
             }
-            const auto nextState = m_dfa.trans(state, nextChar);
+            if constexpr (linear) {
+                if (m_memo.template failed<ArrayDFA>(m_stateStack.back().state, forwardOffset())) { // ֪ٽ
+                    break;
+                }
+            }
+            const auto nextState = m_dfa.trans(m_stateStack.back().state, *m_forward);
             if (nextState == m_dfa.null_state) {
+                if constexpr (hasSentinel) {
+                    if (m_forward == m_limit && refill()) { // ڱǰ
+                        continue;
+                    }
+                }
                 break;
             }
-            m_stateStack.push_back(nextState);
+            ++m_forward;
+            if constexpr (interning) {
+                if (hashes(nextState)) {
+                    hash = SymbolTable::step(hash, m_forward[-1]);
+                }
+            }
+            if constexpr (Skip::enabled) {
+                if (Skip::loops(nextState)) {
+                    // ϵԻνջĶϣʹÿεĩβԻεĩβ
+                    if (nextState == m_stateStack.back().state) {
+                        m_stateStack.back().length += 1;
+                    } else {
+                        m_stateStack.push_back({ nextState, 1 });
+                        if constexpr (linear) {
+                            if (m_memo.template failed<ArrayDFA>(nextState, forwardOffset())) { // ʧܵĶڣ
+                                break;
+                            }
+                        }
+                    }
+                    const auto skipped = Skip::skip(nextState, m_forward, m_limit) - m_forward;
+                    m_stateStack.back().length += skipped;
+                    if constexpr (interning) {
+                        if (hashes(nextState)) {
+                            hash = SymbolTable::extend(hash, { m_forward, static_cast<size_t>(skipped) });
+                            if (accepts(nextState)) {
+                                acceptHash = hash;
+                            }
+                        }
+                    }
+                    m_forward += skipped;
+                    continue;
+                }
+            }
+            m_stateStack.push_back({ nextState, 1 });
+            if constexpr (interning) {
+                if (accepts(nextState)) {
+                    acceptHash = hash;
+                }
+            }
         }
         // backtracking
-        while (!m_stateStack.empty()) {
-            const auto label = m_dfa.label(m_stateStack.back());
-            m_stateStack.pop_back();
+        while (m_stateStack.size() > 1) {
+            const auto [state, length] = m_stateStack.back();
+            const auto label = m_dfa.label(state);
             if (label != 0) {
-                const auto lexeme = std::string(m_begin, m_forward);
-                m_begin = m_forward;
-                return { label, lexeme };
+                m_hash = acceptHash;
+                return { label, static_cast<std::uint64_t>(m_forward - m_begin) };
+            }
+            if constexpr (linear) {
+                m_memo.template fail<ArrayDFA>(state, length, forwardOffset());
             }
+            m_stateStack.pop_back();
+            m_forward -= length;
         }
-        // TODO: No lexeme found error handling
-        m_begin = m_forward;
-        return { -1 , "" };
+        return skipInvalid();
     }
 
-private:
-    Buffer& loadBuffer() { // ȡµļǰʹõĻ
-        // TODO: log read status here
-        while (!m_curFile.is_open()) {
-            if (m_sources.empty()) {
-                return currentBuffer();
+    constexpr static bool interned(std::uint32_t label) {
+        return Interned::contains(label);
+    }
+
+    // פǣhashedʾӸ״̬ܵInternedǩ״̬ؾ״̬ټɢֵ
+    // acceptedʾ״̬Internedǩʱ֪ɢֵ
+    constexpr static std::uint8_t hashed = 1;
+    constexpr static std::uint8_t accepted = 2;
+
+    bool hashes(int state) const {
+        return m_interned[m_dfa.row(state)] & hashed;
+    }
+
+    bool accepts(int state) const {
+        return m_interned[m_dfa.row(state)] & accepted;
+    }
+
+    // תҳпɴ״̬ǽInternedǩ״̬ת򴫲hashedǡ
+    // ﲻЩ״̬ǰ׺(հסעַ͡)ɨʱ㲻ɢֵ
+    // shuffle_dfaתconstexprruntime_dfaתʱȷڹʱһ
+    void markInterned() {
+        std::vector<int> states { m_dfa.initial_state };
+        std::vector<int> marked; // 򴫲
+        std::array<std::vector<int>, ArrayDFA::states_size + 1> sources; // תе
+        std::array<bool, ArrayDFA::states_size + 1> reached {};
+        reached[m_dfa.row(m_dfa.initial_state)] = true;
+        for (size_t i = 0; i < states.size(); i++) {
+            const auto state = states[i];
+            if (interned(m_dfa.label(state))) {
+                m_interned[m_dfa.row(state)] = hashed | accepted;
+                marked.push_back(m_dfa.row(state));
+            }
+            for (int byte = 0; byte <= UINT8_MAX; byte++) {
+                const auto next = m_dfa.trans(state, static_cast<char>(byte));
+                if (next == m_dfa.null_state) {
+                    continue;
+                }
+                sources[m_dfa.row(next)].push_back(m_dfa.row(state));
+                if (!reached[m_dfa.row(next)]) {
+                    reached[m_dfa.row(next)] = true;
+                    states.push_back(next);
+                }
             }
-            const auto newFile = m_sources.front();
-            m_sources.pop();
-            m_curFile.open(newFile);
         }
-        m_curFile.read(&currentBuffer()[0], N);
-        if (m_curFile.eof()) {
-            m_curFile.close();
+        while (!marked.empty()) {
+            const auto row = marked.back();
+            marked.pop_back();
+            for (const auto source : sources[row]) {
+                if (!(m_interned[source] & hashed)) {
+                    m_interned[source] |= hashed;
+                    marked.push_back(source);
+                }
+            }
         }
-        return currentBuffer();
+    }
+
+    std::pair<std::uint32_t, std::uint64_t> skipInvalid() { // ʱm_forward˻m_begin
+        // ޷ʶַ֤ɨܼǰ
+        if (m_forward == m_limit) { // ǰʱѾȷϹ޷
+            return { Lexeme::invalid, 0 };
+        }
+        ++m_forward;
+        return { Lexeme::invalid, 1 };
+    }
+
+    const char* bufferAt(std::uint64_t offset) const { // ǰԴļƫΪoffsetֽڻеλ
+        return m_begin - (m_offset - offset);
+    }
+
+    std::uint64_t forwardOffset() const { // m_forwardڵǰԴļеƫ
+        return m_offset + (m_forward - m_begin);
+    }
+
+    void consume(size_t length) { // [m_begin, m_forward)Ϊһ
+        m_offset += length;
+        m_lexeme = m_begin;
+        m_begin = m_forward;
     }
 
 private:
     // ļȡسԱ
     std::queue<fs::path> m_sources;
     std::ifstream m_curFile;
+    std::uint32_t m_sourceIndex = static_cast<std::uint32_t>(-1);
+    std::vector<std::uint32_t> m_failures;
+    std::uint64_t m_offset = 0; // m_beginڵǰԴļеƫ
 
     // سԱ
-    DualBuffer m_buffer;
-    BufferIter m_begin;
-    BufferIter m_forward;
-    size_t m_bufferIndex;
+    std::array<Block, 2> m_blocks; // ǰ뱸ÿ
+    size_t m_active = 0;
+    size_t m_reserve;              // ĴС
+    char* m_begin = nullptr;
+    char* m_forward = nullptr;
+    char* m_limit = nullptr;       // ǰݵĩβڱڵλ
+    const char* m_lexeme = nullptr; // һηصĴصʼλ
+
+    // ̨ԤسԱ
+    std::thread m_ioThread;
+    std::mutex m_ioMutex;
+    std::condition_variable m_ioCond;
+    char* m_ioData = nullptr; // Ԥλ
+    size_t m_ioCount = 0;
+    bool m_ioPending = false;
+    bool m_ioStop = false;
 
     // ״̬سԱ
+    struct Run {
+        int state;
+        std::uint64_t length; // ڸ״̬λ
+    };
+
     ArrayDFA m_dfa;
-    std::vector<int> m_stateStack;
+    std::vector<Run> m_stateStack;
+    FailureMemo<ArrayDFA::states_size + 1> m_memo;
+
+    // λøسԱ
+    LineTracker m_lines;
+
+    // פسԱ
+    SymbolTable m_symbols;
+    std::uint64_t m_hash = 0; // һνܵĴصɢֵ
+    std::array<std::uint8_t, ArrayDFA::states_size + 1> m_interned {}; // ״̬ڵmarkInterned
 };
 
 #endif // !SCANNER_H_
@@ -0,0 +1,114 @@
+#ifndef SELF_LOOP_H_
+#define SELF_LOOP_H_
+#include <array>
+#include <cstdint>
+#include <utility>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SELF_LOOP_SSE2
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// 自环加速：空白、标识符、注释与字符串的主体都编译为在一大类字节上自环的状态。
+// 状态机进入这样的状态后，用向量比较成段跳过属于该类的字节，而不是逐字节查表。
+// 每个自环状态的字节区间在编译期已知，各自生成一个区间常量内联的跳过函数，按状态索引查表调用。
+// ArrayDFA::self_loops按状态所在的行ArrayDFA::row(state)索引，须提供区间数size与闭区间数组ranges，见cp::array_dfa_2d。
+template <class ArrayDFA>
+class SelfLoop {
+public:
+    using Kernel = const char* (*)(const char*, const char*);
+
+    // 是否存在可加速的自环，不存在时扫描器不做任何额外检查
+    constexpr static bool enabled = [] {
+        for (const auto& loop : ArrayDFA::self_loops) {
+            if (loop.size != 0) {
+                return true;
+            }
+        }
+        return false;
+    }();
+
+    static bool loops(int state) {
+        return ArrayDFA::self_loops[ArrayDFA::row(state)].size != 0;
+    }
+
+    // 状态state在[first, last)上连续自环，返回第一个不属于自环的字节的位置
+    static const char* skip(int state, const char* first, const char* last) {
+        return kernels[ArrayDFA::row(state)](first, last);
+    }
+
+private:
+    template <size_t State>
+    static bool member(std::uint8_t byte) {
+        constexpr auto& loop = ArrayDFA::self_loops[State];
+        bool result = false;
+        for (size_t i = 0; i < loop.size; i++) {
+            result |= static_cast<std::uint8_t>(byte - loop.ranges[i][0]) <= loop.ranges[i][1] - loop.ranges[i][0];
+        }
+        return result;
+    }
+
+    static unsigned lowestBit(std::uint32_t mask) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    // 区间测试：(x - lo)按无符号比较不大于(hi - lo)，用min与相等比较实现无符号的不大于
+    template <size_t State>
+    static const char* kernel(const char* first, const char* last) {
+        constexpr auto& loop = ArrayDFA::self_loops[State];
+#if defined(__AVX2__)
+        for (; last - first >= 32; first += 32) {
+            const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+            auto in = _mm256_setzero_si256();
+            for (size_t i = 0; i < loop.size; i++) {
+                const auto shifted = _mm256_sub_epi8(chunk, _mm256_set1_epi8(static_cast<char>(loop.ranges[i][0])));
+                const auto width = _mm256_set1_epi8(static_cast<char>(loop.ranges[i][1] - loop.ranges[i][0]));
+                in = _mm256_or_si256(in, _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, width), shifted));
+            }
+            const auto out = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(in));
+            if (out != 0) {
+                return first + lowestBit(out);
+            }
+        }
+#endif
+#if defined(SELF_LOOP_SSE2)
+        for (; last - first >= 16; first += 16) {
+            const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+            auto in = _mm_setzero_si128();
+            for (size_t i = 0; i < loop.size; i++) {
+                const auto shifted = _mm_sub_epi8(chunk, _mm_set1_epi8(static_cast<char>(loop.ranges[i][0])));
+                const auto width = _mm_set1_epi8(static_cast<char>(loop.ranges[i][1] - loop.ranges[i][0]));
+                in = _mm_or_si128(in, _mm_cmpeq_epi8(_mm_min_epu8(shifted, width), shifted));
+            }
+            const auto out = ~static_cast<std::uint32_t>(_mm_movemask_epi8(in)) & 0xFFFF;
+            if (out != 0) {
+                return first + lowestBit(out);
+            }
+        }
+#endif
+        while (first != last && member<State>(static_cast<std::uint8_t>(*first))) {
+            ++first;
+        }
+        return first;
+    }
+
+    template <size_t... States>
+    constexpr static std::array<Kernel, sizeof...(States)> make_kernels(std::index_sequence<States...>) {
+        return { { (ArrayDFA::self_loops[States].size != 0 ? &kernel<States> : nullptr)... } };
+    }
+
+    constexpr static auto kernels = make_kernels(std::make_index_sequence<ArrayDFA::self_loops.size()>{});
+};
+
+#endif // !SELF_LOOP_H_
@@ -0,0 +1,124 @@
+#ifndef SHA256_H_
+#define SHA256_H_
+#include <array>
+#include <algorithm>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+// SHA-256摘要(FIPS 180-4)。词素缓存以源文件内容的摘要为键，
+// 须能抵御刻意构造的碰撞，不能使用可逆的快速散列。
+class Sha256 {
+public:
+    using Digest = std::array<std::uint8_t, 32>;
+
+    static Digest digest(std::string_view data) {
+        Sha256 sha;
+        sha.update(data);
+        return sha.finish();
+    }
+
+    void update(std::string_view data) {
+        m_length += data.size();
+        if (m_buffered != 0) { // 先补满上次剩下的块
+            const auto count = std::min(data.size(), blockSize - m_buffered);
+            std::memcpy(m_block.data() + m_buffered, data.data(), count);
+            m_buffered += count;
+            data.remove_prefix(count);
+            if (m_buffered < blockSize) {
+                return;
+            }
+            compress(m_block.data());
+            m_buffered = 0;
+        }
+        for (; data.size() >= blockSize; data.remove_prefix(blockSize)) {
+            compress(reinterpret_cast<const std::uint8_t*>(data.data()));
+        }
+        std::memcpy(m_block.data(), data.data(), data.size());
+        m_buffered = data.size();
+    }
+
+    Digest finish() {
+        const auto bits = m_length * 8;
+        m_block[m_buffered++] = 0x80;
+        if (m_buffered > blockSize - 8) { // 放不下长度，填充一整块
+            std::memset(m_block.data() + m_buffered, 0, blockSize - m_buffered);
+            compress(m_block.data());
+            m_buffered = 0;
+        }
+        std::memset(m_block.data() + m_buffered, 0, blockSize - 8 - m_buffered);
+        for (int i = 0; i < 8; i++) {
+            m_block[blockSize - 1 - i] = static_cast<std::uint8_t>(bits >> (8 * i));
+        }
+        compress(m_block.data());
+        Digest result;
+        for (size_t i = 0; i < 8; i++) {
+            for (int j = 0; j < 4; j++) {
+                result[i * 4 + j] = static_cast<std::uint8_t>(m_state[i] >> (24 - 8 * j));
+            }
+        }
+        return result;
+    }
+
+private:
+    constexpr static size_t blockSize = 64;
+
+    constexpr static std::uint32_t rounds[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+
+    static std::uint32_t rotate(std::uint32_t x, int n) {
+        return (x >> n) | (x << (32 - n));
+    }
+
+    void compress(const std::uint8_t* block) {
+        std::uint32_t w[64];
+        for (int i = 0; i < 16; i++) { // 大端序读入
+            w[i] = std::uint32_t(block[i * 4]) << 24 | std::uint32_t(block[i * 4 + 1]) << 16
+                | std::uint32_t(block[i * 4 + 2]) << 8 | std::uint32_t(block[i * 4 + 3]);
+        }
+        for (int i = 16; i < 64; i++) {
+            const auto s0 = rotate(w[i - 15], 7) ^ rotate(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const auto s1 = rotate(w[i - 2], 17) ^ rotate(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        auto a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3];
+        auto e = m_state[4], f = m_state[5], g = m_state[6], h = m_state[7];
+        for (int i = 0; i < 64; i++) {
+            const auto t1 = h + (rotate(e, 6) ^ rotate(e, 11) ^ rotate(e, 25)) + ((e & f) ^ (~e & g)) + rounds[i] + w[i];
+            const auto t2 = (rotate(a, 2) ^ rotate(a, 13) ^ rotate(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        m_state[0] += a;
+        m_state[1] += b;
+        m_state[2] += c;
+        m_state[3] += d;
+        m_state[4] += e;
+        m_state[5] += f;
+        m_state[6] += g;
+        m_state[7] += h;
+    }
+
+private:
+    std::array<std::uint32_t, 8> m_state { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+    std::array<std::uint8_t, blockSize> m_block {};
+    size_t m_buffered = 0;
+    std::uint64_t m_length = 0; // 已输入的字节数
+};
+
+#endif // !SHA256_H_
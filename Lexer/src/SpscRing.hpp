@@ -0,0 +1,90 @@
+#ifndef SPSC_RING_H_
+#define SPSC_RING_H_
+#include <array>
+#include <atomic>
+#include <thread>
+#include <cstddef>
+
+// 有界的单生产者单消费者无锁环形队列，槽位预先构造并反复使用。
+// 生产者取得空槽、就地填充后发布，消费者取得数据槽、使用后归还，每次交接只有一次原子写。
+// 两端的下标各占一个缓存行，并各自缓存对方的下标，只有缓存的值显示已满或已空时才读取对方的缓存行。
+// 队列满时生产者等待，即反压；生产者关闭队列后，消费者取完剩余数据即得到结束信号。
+template <class T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // 生产者：等待并返回下一个空槽，消费者已取消时返回nullptr
+    T* acquire() {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        for (unsigned spins = 0; tail - m_cachedHead == Capacity; spins++) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (m_cancelled.load(std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            if (tail - m_cachedHead == Capacity) {
+                wait(spins);
+            }
+        }
+        return &m_slots[tail & (Capacity - 1)];
+    }
+
+    // 生产者：发布acquire返回的槽
+    void publish() {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // 生产者：输入结束，之后不再发布
+    void close() {
+        m_closed.store(true, std::memory_order_release);
+    }
+
+    // 消费者：等待并返回最早发布的槽，队列已关闭且取空时返回nullptr
+    T* front() {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        for (unsigned spins = 0; head == m_cachedTail; spins++) {
+            const auto closed = m_closed.load(std::memory_order_acquire); // 先读关闭标志，保证不会漏掉关闭前的发布
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail) {
+                if (closed) {
+                    return nullptr;
+                }
+                wait(spins);
+            }
+        }
+        return &m_slots[head & (Capacity - 1)];
+    }
+
+    // 消费者：归还front返回的槽
+    void release() {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // 消费者：不再消费，使等待中的生产者退出
+    void cancel() {
+        m_cancelled.store(true, std::memory_order_relaxed);
+    }
+
+private:
+    static void wait(unsigned spins) { // 短暂自旋后让出处理器
+        if (spins >= 64) {
+            std::this_thread::yield();
+        }
+    }
+
+    constexpr static size_t cacheLine = 64;
+
+    // 消费者写入的成员
+    alignas(cacheLine) std::atomic<size_t> m_head { 0 };
+    size_t m_cachedTail = 0;
+
+    // 生产者写入的成员
+    alignas(cacheLine) std::atomic<size_t> m_tail { 0 };
+    size_t m_cachedHead = 0;
+
+    alignas(cacheLine) std::atomic<bool> m_closed { false };
+    std::atomic<bool> m_cancelled { false };
+    std::array<T, Capacity> m_slots;
+};
+
+#endif // !SPSC_RING_H_
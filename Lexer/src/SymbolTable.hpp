@@ -0,0 +1,124 @@
+#ifndef SYMBOL_TABLE_H_
+#define SYMBOL_TABLE_H_
+#include <memory>
+#include <vector>
+#include <string_view>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// 标识符驻留表：相同的文本总是得到相同的符号编号，编号从0开始连续分配。
+// 文本被复制到按块分配的内存池中，在符号表析构前一直有效；
+// 散列表采用开放寻址与线性探测，只保存散列值与编号，比较文本时才访问内存池。
+// 散列函数为逐字节的FNV-1a，扫描器可以在状态机行走的同时计算出词素的散列值。
+class SymbolTable {
+public:
+    using Symbol = std::uint32_t;
+
+    constexpr static std::uint64_t seed = 14695981039346656037ull;
+
+    // 散列值累加一个字节
+    constexpr static std::uint64_t step(std::uint64_t hash, char byte) {
+        return (hash ^ static_cast<std::uint8_t>(byte)) * 1099511628211ull;
+    }
+
+    // 散列值累加一段字节
+    static std::uint64_t extend(std::uint64_t hash, std::string_view text) {
+        for (const auto byte : text) {
+            hash = step(hash, byte);
+        }
+        return hash;
+    }
+
+    static std::uint64_t hash(std::string_view text) {
+        return extend(seed, text);
+    }
+
+    Symbol intern(std::string_view text) {
+        return intern(text, hash(text));
+    }
+
+    // hash须等于hash(text)，供已在扫描中算出散列值的调用者使用
+    Symbol intern(std::string_view text, std::uint64_t hash) {
+        if ((m_strings.size() + 1) * 2 > m_slots.size()) { // 装填因子不超过1/2
+            grow();
+        }
+        const auto mask = m_slots.size() - 1;
+        for (auto index = slotOf(hash) & mask; ; index = (index + 1) & mask) {
+            auto& slot = m_slots[index];
+            if (slot.symbol == vacant) {
+                slot = { hash, static_cast<Symbol>(m_strings.size()) };
+                m_strings.push_back(store(text));
+                return slot.symbol;
+            }
+            if (slot.hash == hash && m_strings[slot.symbol] == text) {
+                return slot.symbol;
+            }
+        }
+    }
+
+    std::string_view str(Symbol symbol) const {
+        return m_strings[symbol];
+    }
+
+    size_t size() const {
+        return m_strings.size();
+    }
+
+private:
+    constexpr static Symbol vacant = static_cast<Symbol>(-1);
+    constexpr static size_t initialSlots = 256;
+    constexpr static size_t chunkSize = 64 * 1024;
+
+    struct Slot {
+        std::uint64_t hash;
+        Symbol symbol;
+    };
+
+    static size_t slotOf(std::uint64_t hash) { // FNV的低位较弱，混入高位
+        return static_cast<size_t>(hash ^ (hash >> 32));
+    }
+
+    void grow() {
+        std::vector<Slot> slots(std::max(m_slots.size() * 2, initialSlots), Slot { 0, vacant });
+        const auto mask = slots.size() - 1;
+        for (const auto& slot : m_slots) {
+            if (slot.symbol == vacant) {
+                continue;
+            }
+            auto index = slotOf(slot.hash) & mask;
+            while (slots[index].symbol != vacant) {
+                index = (index + 1) & mask;
+            }
+            slots[index] = slot;
+        }
+        m_slots.swap(slots);
+    }
+
+    std::string_view store(std::string_view text) { // 将文本复制到内存池中
+        if (text.empty()) {
+            return {};
+        }
+        if (text.size() > static_cast<size_t>(m_chunkEnd - m_chunkPos)) {
+            const auto size = std::max(text.size(), chunkSize); // 超长文本单独占据一块
+            m_chunks.push_back(std::make_unique<char[]>(size));
+            m_chunkPos = m_chunks.back().get();
+            m_chunkEnd = m_chunkPos + size;
+        }
+        const auto data = m_chunkPos;
+        std::memcpy(data, text.data(), text.size());
+        m_chunkPos += text.size();
+        return { data, text.size() };
+    }
+
+private:
+    std::vector<Slot> m_slots;
+    std::vector<std::string_view> m_strings; // 按编号索引的文本
+
+    // 内存池相关成员
+    std::vector<std::unique_ptr<char[]>> m_chunks;
+    char* m_chunkPos = nullptr;
+    char* m_chunkEnd = nullptr;
+};
+
+#endif // !SYMBOL_TABLE_H_
@@ -0,0 +1,130 @@
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+// 工作窃取线程池：每个工作线程拥有自己的任务队列，从队首取任务；
+// 自己的队列为空时从其他线程的队尾窃取任务，使耗时不均的任务能自然地均衡。
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(size_t threads = defaultThreads()) {
+        threads = std::max<size_t>(threads, 1);
+        for (size_t i = 0; i < threads; i++) {
+            m_workers.push_back(std::make_unique<Worker>());
+        }
+        for (size_t i = 0; i < threads; i++) {
+            m_threads.emplace_back([this, i] { workerLoop(i); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cond.notify_all();
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    static size_t defaultThreads() {
+        return std::max<unsigned>(std::thread::hardware_concurrency(), 1);
+    }
+
+    size_t size() const { return m_threads.size(); }
+
+    // 提交任务：工作线程内提交的任务进入自己的队列，外部提交的任务轮流分配。
+    // 计数与入队在m_mutex下一并完成，任何工作线程取到的任务都已被计入，计数不会减为负数
+    void submit(Task task) {
+        const auto index = (t_pool == this) ? t_index : m_next++ % m_workers.size();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending += 1;
+            auto& worker = *m_workers[index];
+            std::lock_guard<std::mutex> workerLock(worker.mutex);
+            worker.tasks.push_back(std::move(task));
+        }
+        m_cond.notify_one();
+    }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool popLocal(size_t index, Task& task) { // 从自己的队首取任务
+        auto& worker = *m_workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (worker.tasks.empty()) {
+            return false;
+        }
+        task = std::move(worker.tasks.front());
+        worker.tasks.pop_front();
+        return true;
+    }
+
+    bool steal(size_t index, Task& task) { // 从其他线程的队尾窃取任务
+        for (size_t i = 1; i < m_workers.size(); i++) {
+            auto& victim = *m_workers[(index + i) % m_workers.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.back());
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(size_t index) {
+        t_pool = this;
+        t_index = index;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cond.wait(lock, [this] { return m_pending > 0 || m_stop; });
+                if (m_pending == 0) { // 停止且任务全部完成
+                    return;
+                }
+            }
+            Task task;
+            if (popLocal(index, task) || steal(index, task)) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_pending -= 1;
+                }
+                task();
+            }
+        }
+    }
+
+private:
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+    std::atomic<size_t> m_next = 0;
+
+    // 等待任务相关成员
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    size_t m_pending = 0;
+    bool m_stop = false;
+
+    inline static thread_local ThreadPool* t_pool = nullptr;
+    inline static thread_local size_t t_index = 0;
+};
+
+#endif // !THREAD_POOL_H_
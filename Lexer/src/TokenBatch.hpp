@@ -0,0 +1,59 @@
+#ifndef TOKEN_BATCH_H_
+#define TOKEN_BATCH_H_
+#include "Lexeme.hpp"
+#include <vector>
+#include <cstddef>
+
+// 结构数组形式的词素批，各数组按下标一一对应，便于下游对标签数组作向量化的遍历
+class TokenBatch {
+public:
+    // 每个词素在各数组中共占用的字节数
+    constexpr static size_t tokenBytes = sizeof(Lexeme::label) + sizeof(Lexeme::source) + sizeof(Lexeme::offset) + sizeof(Lexeme::length);
+
+    // 默认容量使一整批词素能同时驻留在一级数据缓存中
+    constexpr static size_t cacheBytes = 32 * 1024;
+    constexpr static size_t defaultCapacity = 1024;
+    static_assert(defaultCapacity * tokenBytes <= cacheBytes, "default batch should fit in L1 data cache");
+
+    explicit TokenBatch(size_t capacity = defaultCapacity)
+        : m_labels(capacity), m_sources(capacity), m_offsets(capacity), m_lengths(capacity), m_size(0) {}
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_labels.size(); }
+    bool empty() const { return m_size == 0; }
+    bool full() const { return m_size == capacity(); }
+
+    void clear() { m_size = 0; }
+
+    // 追加一个词素，调用者保证批未满
+    void push(std::uint32_t label, std::uint32_t source, std::uint64_t offset, std::uint64_t length) {
+        m_labels[m_size] = label;
+        m_sources[m_size] = source;
+        m_offsets[m_size] = offset;
+        m_lengths[m_size] = length;
+        m_size += 1;
+    }
+
+    void push(const Lexeme& lexeme) {
+        push(lexeme.label, lexeme.source, lexeme.offset, lexeme.length);
+    }
+
+    Lexeme operator[](size_t i) const {
+        return { m_labels[i], m_sources[i], m_offsets[i], m_lengths[i] };
+    }
+
+    // 各数组的只读视图，有效长度为size()
+    const std::uint32_t* labels() const { return m_labels.data(); }
+    const std::uint32_t* sources() const { return m_sources.data(); }
+    const std::uint64_t* offsets() const { return m_offsets.data(); }
+    const std::uint64_t* lengths() const { return m_lengths.data(); }
+
+private:
+    std::vector<std::uint32_t> m_labels;
+    std::vector<std::uint32_t> m_sources;
+    std::vector<std::uint64_t> m_offsets;
+    std::vector<std::uint64_t> m_lengths;
+    size_t m_size;
+};
+
+#endif // !TOKEN_BATCH_H_
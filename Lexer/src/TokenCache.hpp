@@ -0,0 +1,244 @@
+#ifndef TOKEN_CACHE_H_
+#define TOKEN_CACHE_H_
+#include "MappedFile.hpp"
+#include "Sha256.hpp"
+#include <array>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <random>
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <system_error>
+
+// 磁盘上的词素流缓存，以源文件内容的SHA-256摘要与状态机指纹为键，源文件与状态机都未改变时直接复用。
+// 缓存文件可以直接映射使用：文件头之后是按词素顺序排列的标签数组，然后是各词素长度的变长编码。
+// 标签加1后存储，使无法识别的标签回绕为0，再按最大值选用1、2或4字节的宽度。
+// 词素首尾相接地覆盖整个源文件，长度就是相邻词素偏移之差，故偏移可以在解码时累加得出。
+// 缓存文件按本机字节序存储，只供本机使用；命中前校验整个长度编码，损坏或伪造的文件当作未命中。
+class TokenCache {
+public:
+    constexpr static std::uint32_t version = 2;
+
+    using Digest = Sha256::Digest;
+
+    struct Header {
+        std::array<char, 4> magic;
+        std::uint32_t version;
+        std::uint32_t labelBytes;  // 每个标签的字节数
+        std::uint32_t reserved;
+        std::uint64_t sourceSize;
+        Digest contentDigest;
+        std::uint64_t fingerprint;
+        std::uint64_t count;       // 词素数量
+        std::uint64_t lengthBytes; // 长度编码的字节数
+    };
+
+    // 顺序解码缓存中的词素流，数据须已通过find的校验或由Writer生成，并在解码期间保持有效
+    class Reader {
+    public:
+        Reader() = default;
+        explicit Reader(const char* data) {
+            const auto header = reinterpret_cast<const Header*>(data);
+            m_labels = data + sizeof(Header);
+            m_labelBytes = header->labelBytes;
+            m_count = static_cast<size_t>(header->count);
+            m_lengths = reinterpret_cast<const std::uint8_t*>(m_labels + m_count * m_labelBytes);
+        }
+
+        bool empty() const { return m_index == m_count; }
+
+        // 取出下一个词素的标签与长度
+        std::pair<std::uint32_t, std::uint64_t> next() {
+            std::uint64_t length = 0;
+            for (unsigned shift = 0; ; shift += 7) {
+                const auto byte = *m_lengths++;
+                length |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    break;
+                }
+            }
+            return { label(m_index++), length };
+        }
+
+    private:
+        std::uint32_t label(size_t index) const {
+            switch (m_labelBytes) {
+            case 1: return reinterpret_cast<const std::uint8_t*>(m_labels)[index] - 1u;
+            case 2: return reinterpret_cast<const std::uint16_t*>(m_labels)[index] - 1u;
+            default: return reinterpret_cast<const std::uint32_t*>(m_labels)[index] - 1u;
+            }
+        }
+
+        const char* m_labels = nullptr;
+        std::uint32_t m_labelBytes = 4;
+        const std::uint8_t* m_lengths = nullptr;
+        size_t m_count = 0;
+        size_t m_index = 0;
+    };
+
+    // 编码一个源文件的词素流，得到的数据与缓存文件的内容相同
+    class Writer {
+    public:
+        void push(std::uint32_t label, std::uint64_t length) {
+            m_labels.push_back(label + 1);
+            m_maxLabel = std::max(m_maxLabel, label + 1);
+            do {
+                m_lengths.push_back(static_cast<std::uint8_t>((length & 0x7F) | (length >= 0x80 ? 0x80 : 0)));
+                length >>= 7;
+            } while (length != 0);
+        }
+
+        std::vector<char> finish(std::uint64_t sourceSize, const Digest& contentDigest, std::uint64_t fingerprint) const {
+            const std::uint32_t labelBytes = m_maxLabel <= 0xFF ? 1 : m_maxLabel <= 0xFFFF ? 2 : 4;
+            const Header header { { 'L', 'X', 'T', 'C' }, version, labelBytes, 0, sourceSize, contentDigest, fingerprint,
+                m_labels.size(), m_lengths.size() };
+            std::vector<char> data(sizeof(Header) + m_labels.size() * labelBytes + m_lengths.size());
+            auto out = data.data();
+            std::memcpy(out, &header, sizeof(Header));
+            out += sizeof(Header);
+            for (const auto label : m_labels) { // 按本机字节序截取低位
+                switch (labelBytes) {
+                case 1: *reinterpret_cast<std::uint8_t*>(out) = static_cast<std::uint8_t>(label); break;
+                case 2: *reinterpret_cast<std::uint16_t*>(out) = static_cast<std::uint16_t>(label); break;
+                default: *reinterpret_cast<std::uint32_t*>(out) = label; break;
+                }
+                out += labelBytes;
+            }
+            std::memcpy(out, m_lengths.data(), m_lengths.size());
+            return data;
+        }
+
+    private:
+        std::vector<std::uint32_t> m_labels; // 已加1的标签
+        std::vector<std::uint8_t> m_lengths;
+        std::uint32_t m_maxLabel = 0;
+    };
+
+    TokenCache(fs::path directory, std::uint64_t fingerprint) : m_directory(std::move(directory)), m_fingerprint(fingerprint) {
+        std::error_code error;
+        fs::create_directories(m_directory, error); // 缓存不可用时只是每次都重新扫描
+    }
+
+    std::uint64_t fingerprint() const { return m_fingerprint; }
+
+    // 状态机的指纹：从初始状态出发按广度优先遍历所有可达状态，依次记下各状态的标签与在所有字节上的转换，
+    // 取其SHA-256摘要的前8字节。状态按发现的顺序编号，指纹与状态值的具体表示无关。
+    template <class ArrayDFA>
+    static std::uint64_t fingerprintOf() {
+        ArrayDFA dfa;
+        std::vector<int> order { dfa.initial_state };          // 按发现顺序排列的状态
+        std::vector<std::uint32_t> number(ArrayDFA::states_size + 1); // 按行索引的发现序号，0为尚未发现
+        number[dfa.row(dfa.initial_state)] = 1;
+        Sha256 sha;
+        std::array<std::uint32_t, 257> codes; // 一个状态的标签与转换
+        for (size_t i = 0; i < order.size(); i++) {
+            const auto state = order[i];
+            codes[0] = dfa.label(state);
+            for (int byte = 0; byte < 256; byte++) {
+                const auto next = dfa.trans(state, static_cast<char>(byte));
+                if (next == dfa.null_state) {
+                    codes[byte + 1] = 0;
+                    continue;
+                }
+                auto& code = number[dfa.row(next)];
+                if (code == 0) {
+                    order.push_back(next);
+                    code = static_cast<std::uint32_t>(order.size());
+                }
+                codes[byte + 1] = code;
+            }
+            sha.update({ reinterpret_cast<const char*>(codes.data()), sizeof(codes) });
+        }
+        const auto digest = sha.finish();
+        std::uint64_t result;
+        std::memcpy(&result, digest.data(), sizeof(result));
+        return result;
+    }
+
+    // 源文件内容的摘要
+    static Digest digest(std::string_view data) {
+        return Sha256::digest(data);
+    }
+
+    // 查找源文件的缓存，命中时entry映射缓存文件
+    bool find(std::string_view source, const Digest& contentDigest, MappedFile& entry) const {
+        if (!entry.open(pathOf(contentDigest)) || entry.size() < sizeof(Header)) {
+            return false;
+        }
+        Header header;
+        std::memcpy(&header, entry.data(), sizeof(Header));
+        const auto payload = entry.size() - sizeof(Header);
+        const auto valid = header.magic == std::array<char, 4> { 'L', 'X', 'T', 'C' } && header.version == version
+            && (header.labelBytes == 1 || header.labelBytes == 2 || header.labelBytes == 4)
+            && header.sourceSize == source.size() && header.contentDigest == contentDigest && header.fingerprint == m_fingerprint
+            && header.count <= payload / header.labelBytes && header.lengthBytes == payload - header.count * header.labelBytes
+            && validLengths(entry.data() + entry.size() - header.lengthBytes, entry.data() + entry.size(), header.count, header.sourceSize);
+        if (!valid) { // 文件损坏或被篡改，当作未命中
+            entry.close();
+        }
+        return valid;
+    }
+
+    // 写入缓存：先写临时文件再改名，并发的构建不会读到写了一半的缓存
+    void store(const Digest& contentDigest, const std::vector<char>& data) const {
+        const auto path = pathOf(contentDigest);
+        auto temporary = path;
+        temporary += ".tmp" + std::to_string(std::random_device{}());
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.write(data.data(), static_cast<std::streamsize>(data.size()))) {
+                return;
+            }
+        }
+        std::error_code error;
+        fs::rename(temporary, path, error);
+        if (error) {
+            fs::remove(temporary, error);
+        }
+    }
+
+private:
+    // 长度编码恰好是count个变长整数，每个不超过10字节且不溢出64位，长度之和等于源文件的大小
+    static bool validLengths(const char* first, const char* last, std::uint64_t count, std::uint64_t sourceSize) {
+        auto data = reinterpret_cast<const std::uint8_t*>(first);
+        const auto end = reinterpret_cast<const std::uint8_t*>(last);
+        std::uint64_t total = 0;
+        for (; count != 0; count--) {
+            std::uint64_t length = 0;
+            for (unsigned shift = 0; ; shift += 7) {
+                if (data == end || (shift == 63 && *data > 1)) { // 第10字节只能提供最高位
+                    return false;
+                }
+                const auto byte = *data++;
+                length |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    break;
+                }
+            }
+            if (length > sourceSize - total) {
+                return false;
+            }
+            total += length;
+        }
+        return data == end && total == sourceSize;
+    }
+
+    fs::path pathOf(const Digest& contentDigest) const {
+        char name[96];
+        auto out = name;
+        for (const auto byte : contentDigest) {
+            out += std::snprintf(out, 3, "%02x", byte);
+        }
+        std::snprintf(out, sizeof(name) - (out - name), "-%016llx.tok", static_cast<unsigned long long>(m_fingerprint));
+        return m_directory / name;
+    }
+
+private:
+    fs::path m_directory;
+    std::uint64_t m_fingerprint;
+};
+
+#endif // !TOKEN_CACHE_H_
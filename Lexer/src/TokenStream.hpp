@@ -0,0 +1,80 @@
+#ifndef TOKEN_STREAM_H_
+#define TOKEN_STREAM_H_
+#include "Lexeme.hpp"
+#include "TokenBatch.hpp"
+#include <iterator>
+#include <cstddef>
+
+// 惰性的词素序列，可以直接用于范围for循环：for (const Lexeme& lexeme : TokenStream(scanner))。
+// 词素按批从扫描器中取出，逐个交付时只是批内下标的递增，没有逐词素的扫描器调用。
+// Scanner须提供scan(TokenBatch&, size_t)，各种扫描器均满足；序列只能遍历一次。
+// Scanner只能取得最近一次返回的词素的文本，需要文本时将batchSize设为1，逐个取出词素。
+template <class Scanner>
+class TokenStream {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Lexeme;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Lexeme*;
+        using reference = const Lexeme&;
+
+        iterator() = default;
+        explicit iterator(TokenStream* stream) : m_stream(stream) {}
+
+        const Lexeme& operator*() const { return m_stream->m_current; }
+        const Lexeme* operator->() const { return &m_stream->m_current; }
+
+        iterator& operator++() {
+            if (!m_stream->advance()) {
+                m_stream = nullptr;
+            }
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        // 只有两个尾后迭代器相等
+        bool operator==(const iterator& other) const { return m_stream == other.m_stream; }
+        bool operator!=(const iterator& other) const { return m_stream != other.m_stream; }
+
+    private:
+        TokenStream* m_stream = nullptr;
+    };
+
+    explicit TokenStream(Scanner& scanner, size_t batchSize = TokenBatch::defaultCapacity)
+        : m_scanner(scanner), m_batchSize(batchSize) {}
+
+    TokenStream(const TokenStream&) = delete;
+    TokenStream& operator=(const TokenStream&) = delete;
+
+    iterator begin() {
+        return advance() ? iterator(this) : iterator();
+    }
+
+    iterator end() {
+        return iterator();
+    }
+
+private:
+    bool advance() { // 取出下一个词素，输入结束时返回false
+        if (m_index == m_batch.size()) {
+            if (m_scanner.scan(m_batch, m_batchSize) == 0) {
+                return false;
+            }
+            m_index = 0;
+        }
+        m_current = m_batch[m_index++];
+        return true;
+    }
+
+private:
+    Scanner& m_scanner;
+    size_t m_batchSize;
+    TokenBatch m_batch;
+    size_t m_index = 0;
+    Lexeme m_current {};
+};
+
+#endif // !TOKEN_STREAM_H_
@@ -3,86 +3,290 @@
 #include "dfa.hpp"
 #include "dfa_utility.hpp"
 #include <array>
+#include <cstdint>
+#include <climits>
+#include <type_traits>
 
 
 namespace cp {
 
-template <class DFA>
-struct array_dfa_2d { // ʹַѹĶάʾת״̬
-    // type-traits
+// ܹ[0, max]ֵխ޷
+template <size_t max>
+using least_uint_t = std::conditional_t<(max <= UINT8_MAX), std::uint8_t,
+                     std::conditional_t<(max <= UINT16_MAX), std::uint16_t, std::uint32_t>>;
+
+// 64ҲСnС2ݣn64ʱΪ64
+constexpr size_t row_alignment(size_t n) {
+    size_t alignment = 1;
+    while (alignment < n && alignment < 64) {
+        alignment *= 2;
+    }
+    return alignment;
+}
+
+// array_dfa_2dԴ״ַ̬롢ַΪеתǩʼ״̬
+// Ͳdfaindex_dfaת۵Ϊ飻ֵ״̬fixed_dfa.hppеػ
+template <class DFA, class = void>
+struct array_dfa_source {
     using origin = index_dfa<DFA>;
 
     constexpr static auto charset_size = origin::charset::size;
-    
+
     constexpr static auto states_size = origin::states::size;
 
     constexpr static auto table_size = origin::trans_table::size;
 
-public:
-    template <char ch, char... rest> // sizeof...(rest)Ϊ0ʱch
-    constexpr static auto make_encoder(char_set<char_sequence<ch, rest...>>) {
-        if constexpr (sizeof...(rest) == 0) {
-            std::array<int, CHAR_MAX> encoder{};
-            encoder[ch] = charset_size;
-            return encoder;
+    using state_type = least_uint_t<states_size>;
+
+    // ״̬תеЧ״̬1ʼ״̬0״̬
+    template <class State>
+    constexpr static state_type state_index() {
+        if constexpr (std::is_same_v<State, cp::null_state>) {
+            return 0;
         } else {
-            auto encoder = make_encoder(char_set<char_sequence<rest...>>{});
-            encoder[ch] = charset_size - sizeof...(rest);
-            return encoder;
+            return static_cast<state_type>(std::get<0>(typename State::code{}) + 1);
         }
     }
 
-    // Ч1ʼ0Чת
-    constexpr static auto charset_encoder = make_encoder(typename origin::charset{});
+    // ַÿַı룬Ч1ʼַеֽΪ0
+    template <char... chars>
+    constexpr static auto make_char_encoder(char_set<char_sequence<chars...>>) {
+        std::array<std::uint16_t, 256> encoder{};
+        std::uint16_t code = 0;
+        ((encoder[static_cast<unsigned char>(chars)] = ++code), ...);
+        return encoder;
+    }
+
+    constexpr static auto char_encoder = make_char_encoder(typename origin::charset{});
 
-    template <size_t i>
-    constexpr static auto make_trans_table() {
-        if constexpr (i == 0) {
-            return std::array<std::array<int, charset_size + 1>, states_size + 1> {};
-        } else {
-            using transition = std::tuple_element_t<i, typename origin::trans_table::tuple>;
-            using from_state = typename transition::from_state;
-            using to_state = typename transition::to_state;
-            constexpr auto from = std::get<0>(typename from_state::code{});
-            constexpr auto to = std::is_same_v<to_state, null_state> ? -1 : std::get<0>(typename to_state::code{});
-            constexpr auto cond = charset_encoder[transition::cond];
-            auto table = make_trans_table<i - 1>();
-            table[from + 1][cond] = to + 1; // Ч״̬1ʼ״̬0״̬
-            return table;
-        }
+    template <size_t... I>
+    constexpr static auto make_char_table(std::index_sequence<I...>) {
+        using transitions = typename origin::trans_table::tuple;
+        std::array<std::array<state_type, charset_size + 1>, states_size + 1> table{};
+        ((table[state_index<typename std::tuple_element_t<I, transitions>::from_state>()]
+               [char_encoder[static_cast<unsigned char>(std::tuple_element_t<I, transitions>::cond)]]
+            = state_index<typename std::tuple_element_t<I, transitions>::to_state>()), ...);
+        return table;
+    }
+
+    constexpr static auto char_table = make_char_table(std::make_index_sequence<table_size>{});
+
+    template <size_t... I>
+    constexpr static auto make_label_list(std::index_sequence<I...>) {
+        using states = typename origin::states::tuple;
+        std::array<std::uint32_t, states_size + 1> list{};
+        ((list[state_index<std::tuple_element_t<I, states>>()] = std::tuple_element_t<I, states>::label), ...);
+        return list;
+    }
+
+    constexpr static auto label_list = make_label_list(std::make_index_sequence<states_size>{});
+
+    constexpr static auto initial_state = std::get<0>(typename origin::initial_state::code{}) + 1;
+};
+
+template <class DFA>
+struct array_dfa_2d { // ʹַѹĶάʾת״̬
+    // type-traits
+    using source = array_dfa_source<DFA>;
+
+    using origin = typename source::origin;
+
+    constexpr static auto charset_size = source::charset_size;
+    
+    constexpr static auto states_size = source::states_size;
+
+    // ״̬ͣ״̬ѡȡխ
+    using state_type = least_uint_t<states_size>;
+
+    // ֽͣ256ֳֽ256࣬0κתֽ
+    using cond_type = std::uint8_t;
+
+public:
+    // ַÿַı룬Ч1ʼַеֽΪ0
+    constexpr static auto char_encoder = source::char_encoder;
+
+    // ַΪеתֻڻֽ
+    constexpr static auto char_table = source::char_table;
+
+    struct byte_classes {
+        std::array<cond_type, 256> encoder;
+        std::array<cond_type, charset_size + 1> codes; // ÿַֽ
+        size_t size;
     };
 
-    // ĳԪΪ0ԪضӦת˿״̬
-    constexpr static auto trans_table = make_trans_table<table_size - 1>();
+    // ״̬תֽͬǵȼ۵ģͬһֽࡣ
+    // ఴСֽαţκתֽڶ0
+    // ͬһַֽתͬÿֻڵһʱȽһ
+    constexpr static auto make_byte_classes() {
+        byte_classes classes{};
+        std::array<bool, charset_size + 1> seen{};
+        std::array<std::uint16_t, charset_size + 1> representatives{}; // Сֽڵַ
+        for (size_t byte = 0; byte < 256; byte++) {
+            const auto code = char_encoder[byte];
+            if (code == 0 || seen[code]) {
+                classes.encoder[byte] = classes.codes[code];
+                continue;
+            }
+            seen[code] = true;
+            bool null = true;
+            for (size_t state = 1; state <= states_size && null; state++) {
+                null = char_table[state][code] == 0;
+            }
+            if (null) {
+                continue;
+            }
+            size_t cls = 1;
+            for (; cls <= classes.size; cls++) {
+                bool same = true;
+                for (size_t state = 1; state <= states_size && same; state++) {
+                    same = char_table[state][code] == char_table[state][representatives[cls]];
+                }
+                if (same) {
+                    break;
+                }
+            }
+            if (cls > classes.size) {
+                classes.size = cls;
+                representatives[cls] = code;
+            }
+            classes.codes[code] = static_cast<cond_type>(cls);
+            classes.encoder[byte] = static_cast<cond_type>(cls);
+        }
+        return classes;
+    }
 
-    template <size_t i>
-    constexpr static auto make_label_list() {
-        if constexpr (i == 0) {
-            return std::array<std::uint32_t, states_size + 1> {};
-        } else {
-            using state = std::tuple_element_t<i, typename origin::states::tuple>;
-            constexpr auto code = std::get<0>(typename state::code{});
-            constexpr auto label = state::label;
-            auto list = make_label_list<i - 1>();
-            list[code] = label;
-            return list;
+    constexpr static auto classes = make_byte_classes();
+
+    // ֽ0
+    constexpr static auto classes_size = classes.size;
+    static_assert(classes_size <= UINT8_MAX, "too many byte classes");
+
+    // ÿֽֽ࣬Ч1ʼ0Чת
+    constexpr static auto charset_encoder = classes.encoder;
+
+    // תһСһʱ2ݶ룬ͬһڣʱж
+    struct alignas(row_alignment(sizeof(state_type) * (classes_size + 1))) trans_row {
+        std::array<state_type, classes_size + 1> next;
+
+        constexpr auto& operator[](size_t cond) { return next[cond]; }
+        constexpr auto operator[](size_t cond) const { return next[cond]; }
+    };
+
+    constexpr static auto make_trans_table() {
+        std::array<trans_row, states_size + 1> table{};
+        for (size_t state = 1; state <= states_size; state++) {
+            for (size_t code = 1; code <= charset_size; code++) {
+                table[state][classes.codes[code]] = char_table[state][code];
+            }
         }
+        return table;
     }
 
+    // ֽΪеתĳԪΪ0ԪضӦת˿״̬
+    alignas(64) constexpr static auto trans_table = make_trans_table();
+
     // Ч״̬ǽ״̬ıǩΪ0Ϊ״̬
-    constexpr static auto label_list = make_label_list<states_size - 1>();
+    constexpr static auto label_list = source::label_list;
+
+    constexpr static int make_sentinel() {
+        for (int c = 0; c < static_cast<int>(charset_encoder.size()); c++) {
+            if (charset_encoder[c] == 0) {
+                return c;
+            }
+        }
+        return -1;
+    }
+
+    // ӽ״̬ܵķǿ״̬ǽ״̬ƥһܱ㲻ٻˣ
+    // ǰ״̬ʱͣµλþǴصĩβ
+    constexpr static bool make_backtrack_free() {
+        std::array<bool, states_size + 1> reached{}; // ĳ״̬ɴ
+        for (size_t state = 1; state <= states_size; state++) {
+            reached[state] = label_list[state] != 0;
+        }
+        for (bool changed = true; changed; ) {
+            changed = false;
+            for (size_t state = 1; state <= states_size; state++) {
+                if (!reached[state]) {
+                    continue;
+                }
+                for (size_t cond = 1; cond <= classes_size; cond++) {
+                    const auto to = trans_table[state][cond];
+                    if (to != 0 && !reached[to]) {
+                        reached[to] = true;
+                        changed = true;
+                    }
+                }
+            }
+        }
+        for (size_t state = 1; state <= states_size; state++) {
+            if (reached[state] && label_list[state] == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // ״̬Իǵֽڣ4ʾΪ0״̬ûпɼٵԻ
+    struct self_loop {
+        std::uint8_t size;
+        std::array<std::array<std::uint8_t, 2>, 4> ranges;
+    };
+
+    constexpr static auto make_self_loops() {
+        std::array<self_loop, states_size + 1> loops{};
+        for (size_t state = 1; state <= states_size; state++) {
+            bool any = false; // Ȱֽ飬ûԻ״ֽ̬ɨ
+            for (size_t cond = 1; cond <= classes_size && !any; cond++) {
+                any = trans_table[state][cond] == state;
+            }
+            if (!any) {
+                continue;
+            }
+            auto& loop = loops[state];
+            bool open = false; // ǰδպ
+            for (size_t byte = 0; byte < charset_encoder.size(); byte++) {
+                const auto cond = charset_encoder[byte];
+                const bool member = cond != 0 && trans_table[state][cond] == state;
+                if (member && !open) {
+                    if (loop.size == loop.ranges.size()) { // ֵ࣬ü
+                        loop.size = 0;
+                        break;
+                    }
+                    loop.ranges[loop.size] = { static_cast<std::uint8_t>(byte), static_cast<std::uint8_t>(byte) };
+                    loop.size += 1;
+                } else if (member) {
+                    loop.ranges[loop.size - 1][1] = static_cast<std::uint8_t>(byte);
+                }
+                open = member;
+            }
+        }
+        return loops;
+    }
 
 public:
     // ״̬
     constexpr static auto null_state = 0;
 
-    // ַ
+    // ʼ״̬תһ1ʼ
+    constexpr static auto initial_state = source::initial_state;
+
+    // 0ֽڣκ״̬ᵽ״̬ĩβڱʱΪ-1
+    constexpr static int sentinel = make_sentinel();
+
+    // Ƿݣƥǰ࿴һַ
+    constexpr static bool backtrack_free = make_backtrack_free();
+
+    // ״̬Իֽ䣬ɨЩ״̬ʱԳɶ
+    constexpr static auto self_loops = make_self_loops();
+
+    // ֽֽ࣬κֽڶб룬0x80ϵֽ
     constexpr static auto encode(char c) {
-        return charset_encoder[c];
+        return charset_encoder[static_cast<unsigned char>(c)];
     }
 
     // ״̬Ϊ0תǿ״̬еЧתִ״̬
-    constexpr static auto trans(int state, char cond) {
+    constexpr static int trans(int state, char cond) {
         return trans_table[state][encode(cond)];
     }
 
@@ -90,6 +294,143 @@ public:
     constexpr static auto label(int state) {
         return label_list[state];
     }
+
+    // ״̬ڵУȡֵΪ[0, states_size]״̬ɨʹ
+    constexpr static int row(int state) {
+        return state;
+    }
+};
+
+template <class DFA>
+struct array_dfa_1d { // һάʾת״̬״̬Ԥпƫ
+    // type-traits
+    using origin = array_dfa_2d<DFA>;
+
+    constexpr static auto charset_size = origin::charset_size;
+
+    constexpr static auto states_size = origin::states_size;
+
+    constexpr static auto classes_size = origin::classes_size;
+
+    constexpr static size_t make_row_shift() {
+        size_t shift = 0;
+        while ((size_t(1) << shift) < classes_size + 1) {
+            shift++;
+        }
+        return shift;
+    }
+
+    // пȡ2ݣкżƫrow_shiftλ
+    constexpr static size_t row_shift = make_row_shift();
+    constexpr static size_t row_width = size_t(1) << row_shift;
+
+    using state_type = least_uint_t<states_size * row_width>;
+
+public:
+    // ״̬±źкţ״̬Ϊ0ǽ״̬Σ״̬ȫ
+    constexpr static auto make_rows() {
+        std::array<state_type, states_size + 1> rows{};
+        size_t next = 1;
+        for (size_t state = 1; state <= states_size; state++) {
+            if (origin::label_list[state] == 0) {
+                rows[state] = static_cast<state_type>(next++);
+            }
+        }
+        for (size_t state = 1; state <= states_size; state++) {
+            if (origin::label_list[state] != 0) {
+                rows[state] = static_cast<state_type>(next++);
+            }
+        }
+        return rows;
+    }
+
+    // άתе״̬кŵӳ
+    constexpr static auto rows = make_rows();
+
+    constexpr static size_t make_accept_row() {
+        size_t row = states_size + 1;
+        for (size_t state = 1; state <= states_size; state++) {
+            if (origin::label_list[state] != 0) {
+                row--;
+            }
+        }
+        return row;
+    }
+
+    // һ״̬кţǽ״̬
+    constexpr static size_t accept_row = make_accept_row();
+
+    constexpr static auto make_trans_table() {
+        std::array<state_type, (states_size + 1) * row_width> table{};
+        for (size_t state = 1; state <= states_size; state++) {
+            for (size_t cond = 1; cond <= classes_size; cond++) {
+                table[rows[state] * row_width + cond] = static_cast<state_type>(rows[origin::trans_table[state][cond]] * row_width);
+            }
+        }
+        return table;
+    }
+
+    // ԪĿ״̬ƫƣ״ֽ̬༴õתڵλ
+    alignas(64) constexpr static auto trans_table = make_trans_table();
+
+    constexpr static auto make_label_list() {
+        std::array<std::uint32_t, states_size + 1> list{};
+        for (size_t state = 1; state <= states_size; state++) {
+            list[rows[state]] = origin::label_list[state];
+        }
+        return list;
+    }
+
+    // кеıǩ
+    constexpr static auto label_list = make_label_list();
+
+    constexpr static auto make_self_loops() {
+        std::array<typename origin::self_loop, states_size + 1> loops{};
+        for (size_t state = 1; state <= states_size; state++) {
+            loops[rows[state]] = origin::self_loops[state];
+        }
+        return loops;
+    }
+
+public:
+    // ״̬ƫ
+    constexpr static auto null_state = 0;
+
+    // ʼ״̬ƫ
+    constexpr static int initial_state = static_cast<int>(rows[origin::initial_state] * row_width);
+
+    // С״̬ǽ״̬
+    constexpr static int accept_state = static_cast<int>(accept_row * row_width);
+
+    constexpr static int sentinel = origin::sentinel;
+
+    constexpr static bool backtrack_free = origin::backtrack_free;
+
+    // кԻֽ
+    constexpr static auto self_loops = make_self_loops();
+
+    constexpr static auto encode(char c) {
+        return origin::encode(c);
+    }
+
+    // ÿֻֽһμӷһζȡ
+    constexpr static int trans(int state, char cond) {
+        return trans_table[state + encode(cond)];
+    }
+
+    // ǷΪ״ֻ̬һαȽ
+    constexpr static bool accepting(int state) {
+        return state >= accept_state;
+    }
+
+    // ǽ״ֱ̬ӵõ0ֻн״̬Ŷȡǩ
+    constexpr static std::uint32_t label(int state) {
+        return accepting(state) ? label_list[state >> row_shift] : 0;
+    }
+
+    constexpr static int row(int state) {
+        return state >> row_shift;
+    }
 };
 
 template <class DFA>
@@ -0,0 +1,179 @@
+#ifndef COMB_DFA_H_
+#define COMB_DFA_H_
+#include "array_dfa.hpp"
+#include <array>
+#include <cstdint>
+
+
+namespace cp {
+
+template <class DFA>
+struct comb_dfa { // 行位移压缩（梳状向量）的转换表，适合稠密表放不进缓存的大状态机
+    // type-traits
+    using origin = array_dfa_2d<DFA>;
+
+    constexpr static auto charset_size = origin::charset_size;
+
+    constexpr static auto states_size = origin::states_size;
+
+    constexpr static auto classes_size = origin::classes_size;
+
+    constexpr static auto columns_size = classes_size + 1;
+
+    using state_type = typename origin::state_type;
+
+    using check_type = least_uint_t<states_size + 1>;
+
+    // 不属于任何状态的槽位
+    constexpr static auto vacant = static_cast<check_type>(states_size + 1);
+
+    // 槽位base[state] + cond属于check所记的状态时，next是该状态经过字节类cond的转换
+    struct slot {
+        state_type next;
+        check_type check;
+    };
+
+public:
+    // 每个状态最常见的目标作为默认转换，只有不同于它的转换才放入槽位
+    constexpr static auto make_defaults() {
+        std::array<state_type, states_size + 1> defaults{};
+        for (size_t state = 1; state <= states_size; state++) {
+            std::array<size_t, states_size + 1> count{};
+            for (size_t cond = 0; cond < columns_size; cond++) {
+                count[origin::trans_table[state][cond]] += 1;
+            }
+            for (size_t to = 1; to <= states_size; to++) {
+                if (count[to] > count[defaults[state]]) {
+                    defaults[state] = static_cast<state_type>(to);
+                }
+            }
+        }
+        return defaults;
+    }
+
+    constexpr static auto defaults = make_defaults();
+
+    constexpr static bool explicit_at(size_t state, size_t cond) {
+        return origin::trans_table[state][cond] != defaults[state];
+    }
+
+    // 稠密表大小的排列结果，size是实际用到的槽位数
+    struct layout {
+        std::array<size_t, states_size + 1> base;
+        std::array<slot, (states_size + 1) * columns_size> slots;
+        size_t size;
+    };
+
+    // 首次适配：显式转换多的状态先放，每个状态取使其所有显式转换都落在空槽位上的最小位移
+    constexpr static auto make_layout() {
+        layout result{};
+        for (auto& s : result.slots) {
+            s = { 0, vacant };
+        }
+        std::array<size_t, states_size + 1> order{};
+        std::array<size_t, states_size + 1> weight{};
+        for (size_t state = 0; state <= states_size; state++) {
+            order[state] = state;
+            for (size_t cond = 0; cond < columns_size; cond++) {
+                weight[state] += explicit_at(state, cond);
+            }
+        }
+        for (size_t i = 1; i <= states_size; i++) { // 插入排序，权重相同时保持编号顺序
+            for (size_t j = i; j > 0 && weight[order[j - 1]] < weight[order[j]]; j--) {
+                const auto t = order[j - 1];
+                order[j - 1] = order[j];
+                order[j] = t;
+            }
+        }
+        for (size_t i = 0; i <= states_size; i++) {
+            const auto state = order[i];
+            if (weight[state] == 0) {
+                continue; // 全部走默认转换，位移取0，check不会命中
+            }
+            size_t base = 0;
+            for (;; base++) {
+                bool fits = true;
+                for (size_t cond = 0; cond < columns_size && fits; cond++) {
+                    fits = !explicit_at(state, cond) || result.slots[base + cond].check == vacant;
+                }
+                if (fits) {
+                    break;
+                }
+            }
+            result.base[state] = base;
+            for (size_t cond = 0; cond < columns_size; cond++) {
+                if (explicit_at(state, cond)) {
+                    result.slots[base + cond] = { origin::trans_table[state][cond], static_cast<check_type>(state) };
+                    if (base + cond + 1 > result.size) {
+                        result.size = base + cond + 1;
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    constexpr static auto packed = make_layout();
+
+    // 末尾补足一行，任何位移加上字节类都不会越界
+    constexpr static auto slots_size = packed.size + columns_size;
+
+    using base_type = least_uint_t<slots_size>;
+
+    constexpr static auto make_base() {
+        std::array<base_type, states_size + 1> base{};
+        for (size_t state = 0; state <= states_size; state++) {
+            base[state] = static_cast<base_type>(packed.base[state]);
+        }
+        return base;
+    }
+
+    constexpr static auto make_slots() {
+        std::array<slot, slots_size> slots{};
+        for (size_t i = 0; i < slots_size; i++) {
+            slots[i] = i < packed.size ? packed.slots[i] : slot{ 0, vacant };
+        }
+        return slots;
+    }
+
+    constexpr static auto base = make_base();
+
+    alignas(64) constexpr static auto slots = make_slots();
+
+    // 压缩后转换表占用的字节数，用于与array_dfa_2d::trans_table比较
+    constexpr static auto table_bytes = sizeof(base) + sizeof(slots) + sizeof(defaults);
+
+public:
+    // 状态编号与array_dfa_2d相同
+    constexpr static auto null_state = origin::null_state;
+
+    constexpr static auto initial_state = origin::initial_state;
+
+    constexpr static int sentinel = origin::sentinel;
+
+    constexpr static bool backtrack_free = origin::backtrack_free;
+
+    constexpr static auto self_loops = origin::self_loops;
+
+    constexpr static auto encode(char c) {
+        return origin::encode(c);
+    }
+
+    // 一次槽位读取加一次检查，命中失败时取默认转换，没有循环
+    constexpr static int trans(int state, char cond) {
+        const auto& s = slots[base[state] + encode(cond)];
+        return s.check == state ? s.next : defaults[state];
+    }
+
+    constexpr static auto label(int state) {
+        return origin::label(state);
+    }
+
+    constexpr static int row(int state) {
+        return state;
+    }
+};
+
+}
+
+#endif // !COMB_DFA_H_
@@ -0,0 +1,120 @@
+#ifndef DIRECT_DFA_H_
+#define DIRECT_DFA_H_
+#include "array_dfa.hpp"
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+
+
+namespace cp {
+
+template <class DFA>
+struct direct_dfa { // 直接编码的状态机，每个状态的转换编译为一棵字节区间的比较树，不读取转换表
+    // type-traits
+    using origin = array_dfa_2d<DFA>;
+
+    constexpr static auto charset_size = origin::charset_size;
+
+    constexpr static auto states_size = origin::states_size;
+
+    using state_type = typename origin::state_type;
+
+    // 一段连续的字节，经过它们都转换到同一个非空状态
+    struct byte_range {
+        std::uint8_t first;
+        std::uint8_t last;
+        state_type to;
+    };
+
+    // 一个状态按字节升序排列的所有区间，区间之间的空隙都转换到空状态
+    struct state_ranges {
+        size_t size;
+        std::array<byte_range, 256> ranges;
+    };
+
+public:
+    constexpr static auto make_ranges() {
+        std::array<state_ranges, states_size + 1> result{};
+        for (size_t state = 1; state <= states_size; state++) {
+            auto& ranges = result[state];
+            for (size_t byte = 0; byte < 256; byte++) {
+                const auto to = origin::trans_table[state][origin::charset_encoder[byte]];
+                if (to == 0) {
+                    continue;
+                }
+                if (ranges.size != 0 && ranges.ranges[ranges.size - 1].last + size_t(1) == byte && ranges.ranges[ranges.size - 1].to == to) {
+                    ranges.ranges[ranges.size - 1].last = static_cast<std::uint8_t>(byte);
+                } else {
+                    ranges.ranges[ranges.size] = { static_cast<std::uint8_t>(byte), static_cast<std::uint8_t>(byte), to };
+                    ranges.size += 1;
+                }
+            }
+        }
+        return result;
+    }
+
+    // 只在编译期使用，区间的端点与目标状态都作为立即数写入生成的代码
+    constexpr static auto ranges = make_ranges();
+
+    // 在状态State的第First到第Last - 1个区间中二分查找byte，展开为嵌套的比较与跳转
+    template <size_t State, size_t First, size_t Last>
+    constexpr static int search(std::uint8_t byte) {
+        if constexpr (First == Last) {
+            return 0;
+        } else {
+            constexpr auto mid = (First + Last) / 2;
+            constexpr auto range = ranges[State].ranges[mid];
+            if (byte < range.first) {
+                return search<State, First, mid>(byte);
+            }
+            if (byte > range.last) {
+                return search<State, mid + 1, Last>(byte);
+            }
+            return range.to;
+        }
+    }
+
+    // 按状态分派到各自的比较树，编译器将这串相等比较生成为switch
+    template <size_t... States>
+    constexpr static int dispatch(int state, std::uint8_t byte, std::index_sequence<States...>) {
+        int next = 0;
+        ((state == static_cast<int>(States) && (next = search<States, 0, ranges[States].size>(byte), true)) || ...);
+        return next;
+    }
+
+    template <size_t... States>
+    constexpr static std::uint32_t label_of(int state, std::index_sequence<States...>) {
+        std::uint32_t result = 0;
+        ((state == static_cast<int>(States) && (result = std::integral_constant<std::uint32_t, origin::label_list[States]>::value, true)) || ...);
+        return result;
+    }
+
+public:
+    // 状态编号与array_dfa_2d相同
+    constexpr static auto null_state = origin::null_state;
+
+    constexpr static auto initial_state = origin::initial_state;
+
+    constexpr static int sentinel = origin::sentinel;
+
+    constexpr static bool backtrack_free = origin::backtrack_free;
+
+    constexpr static auto self_loops = origin::self_loops;
+
+    constexpr static int trans(int state, char cond) {
+        return dispatch(state, static_cast<std::uint8_t>(cond), std::make_index_sequence<states_size + 1>{});
+    }
+
+    constexpr static std::uint32_t label(int state) {
+        return label_of(state, std::make_index_sequence<states_size + 1>{});
+    }
+
+    constexpr static int row(int state) {
+        return state;
+    }
+};
+
+}
+
+#endif // !DIRECT_DFA_H_
@@ -0,0 +1,403 @@
+#ifndef FIXED_DFA_H_
+#define FIXED_DFA_H_
+#include "array_dfa.hpp"
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+#include <stdexcept>
+
+
+namespace cp {
+
+/* ---------------------值层的编译期状态机--------------------- */
+// 类型层的ordered_group、group_list与trans_table把每个状态、转换与划分都表示为不同的类型，
+// 每次插入与查找都实例化新的模板，几十个状态以上编译时间与内存急剧增长。
+// fixed_dfa把同样的算法写成std::array上的constexpr函数，编译器只做常量求值，不产生新的类型；
+// 结果经array_dfa_source的特化交给array_dfa_2d，得到与类型层布局完全相同的转换表。
+// 常量求值的每一步都远比运行期昂贵，故转换表从一开始就以字节类为列，各算法的代价与状态数×字节类数成比例，而不是×256。
+
+// 值层的一个转换，状态以[0, Capacity)中的整数编号，to为null时表示显式地转换到空状态
+struct fixed_transition {
+    constexpr static auto null = static_cast<size_t>(-1);
+
+    size_t from;
+    char cond;
+    size_t to;
+};
+
+// 至多Capacity个有效状态、Classes个字节类的确定状态机。状态0为空状态，有效状态从1开始；
+// 所有构造函数都只保留从初始状态可达的状态，并按广度优先的发现顺序编号，同一语言的最小状态机编号唯一。
+// 超出容量或转换不确定时抛出异常，在常量求值中即为编译错误
+template <size_t Capacity, size_t Classes = 64>
+struct fixed_dfa {
+    static_assert(Classes <= UINT8_MAX, "too many byte classes");
+
+    using state_type = least_uint_t<Capacity>;
+
+    std::array<std::uint8_t, 256> encoder{}; // 字节所属的字节类，类按其最小的字节依次编号，类0的字节不引起任何转换
+    size_t classes_size = 0;
+    std::array<std::array<state_type, Classes + 1>, Capacity + 1> next{}; // next[state][class]为转换到达的状态
+    std::array<std::uint32_t, Capacity + 1> labels{};
+    size_t states_size = 0;
+    size_t initial_state = 0;
+
+    constexpr size_t trans(size_t state, char cond) const {
+        return next[state][encoder[static_cast<unsigned char>(cond)]];
+    }
+
+    // 由转换列表构造，对应dfa<init_trans_table<...>, Initial, Accepts>，labels按状态编号给出标签。
+    // 转换按(字节, 源状态, 目标)排序去重后，转换列表相同的字节即归入同一个字节类
+    template <size_t N, size_t L>
+    constexpr static fixed_dfa from_transitions(const std::array<fixed_transition, N>& transitions, size_t initial, const std::array<std::uint32_t, L>& labels) {
+        static_assert(L <= Capacity, "more labels than states");
+        auto key = [&](size_t i) {
+            return std::array<size_t, 3>{ static_cast<unsigned char>(transitions[i].cond), transitions[i].from, transitions[i].to };
+        };
+        std::array<size_t, N + 1> order{};
+        for (size_t i = 0; i < N; i++) {
+            order[i] = i;
+        }
+        sort(order, N, [&](size_t a, size_t b) { // std::array的比较在C++17中不是constexpr
+            const auto ka = key(a);
+            const auto kb = key(b);
+            return ka[0] != kb[0] ? ka[0] < kb[0] : ka[1] != kb[1] ? ka[1] < kb[1] : ka[2] < kb[2];
+        });
+        size_t size = 0;
+        for (size_t i = 0; i < N; i++) {
+            const auto& t = transitions[order[i]];
+            if (t.from >= Capacity || (t.to != fixed_transition::null && t.to >= Capacity)) {
+                throw std::length_error("fixed_dfa: state out of capacity");
+            }
+            if (size != 0) {
+                const auto prev = key(order[size - 1]);
+                const auto curr = key(order[i]);
+                if (prev[0] == curr[0] && prev[1] == curr[1]) {
+                    if (prev[2] == curr[2]) {
+                        continue; // 重复的转换
+                    }
+                    throw std::logic_error("fixed_dfa: nondeterministic transition");
+                }
+            }
+            order[size++] = order[i];
+        }
+
+        fixed_dfa raw{}; // 状态s放在第s + 1行，之后按可达性重新编号
+        raw.states_size = Capacity;
+        std::array<size_t, Classes + 1> first{}; // 各类的第一个字节在order中的转换区间
+        std::array<size_t, Classes + 1> last{};
+        size_t i = 0;
+        for (size_t byte = 0; byte < 256; byte++) {
+            const auto begin = i;
+            while (i < size && key(order[i])[0] == byte) {
+                i++;
+            }
+            if (begin == i) {
+                continue; // 没有任何转换的字节属于类0
+            }
+            size_t cls = 1;
+            for (; cls <= raw.classes_size; cls++) {
+                bool same = last[cls] - first[cls] == i - begin;
+                for (size_t k = 0; k < i - begin && same; k++) {
+                    const auto a = key(order[first[cls] + k]);
+                    const auto b = key(order[begin + k]);
+                    same = a[1] == b[1] && a[2] == b[2];
+                }
+                if (same) {
+                    break;
+                }
+            }
+            if (cls > raw.classes_size) {
+                if (cls > Classes) {
+                    throw std::length_error("fixed_dfa: too many byte classes");
+                }
+                raw.classes_size = cls;
+                first[cls] = begin;
+                last[cls] = i;
+                for (auto k = begin; k < i; k++) {
+                    const auto& t = transitions[order[k]];
+                    raw.next[t.from + 1][cls] = static_cast<state_type>(t.to == fixed_transition::null ? 0 : t.to + 1);
+                }
+            }
+            raw.encoder[byte] = static_cast<std::uint8_t>(cls);
+        }
+        for (size_t state = 0; state < L; state++) {
+            raw.labels[state + 1] = labels[state];
+        }
+        raw.initial_state = initial + 1;
+        return reachable(raw);
+    }
+
+    // 由类型层的dfa构造，只按转换逐个折叠，不经过index_dfa
+    template <class DFA>
+    constexpr static fixed_dfa of() {
+        static_assert(DFA::states::size <= Capacity, "too many states");
+        return of<DFA>(std::make_index_sequence<DFA::trans_table::size>{}, std::make_index_sequence<DFA::states::size>{});
+    }
+
+    // 最小化，对应min_dfa：初始划分按标签分组，之后逐个字节类按(所在组, 转换到达的组)细分，直到一整轮都不再细分。
+    // 每次细分先按到达的组分桶，同一组的状态在桶中按到达的组依次出现，不需要比较排序，代价与状态数成线性
+    constexpr static fixed_dfa min_dfa(const fixed_dfa& dfa) {
+        constexpr auto unnumbered = static_cast<size_t>(-1);
+        const auto size = dfa.states_size + 1;
+        std::array<size_t, Capacity + 1> group{};
+        std::array<size_t, Capacity + 1> order{};
+        for (size_t state = 0; state < size; state++) {
+            order[state] = state;
+        }
+        sort(order, size, [&](size_t a, size_t b) { return dfa.labels[a] < dfa.labels[b]; });
+        size_t groups = 1;
+        for (size_t i = 1; i < size; i++) {
+            if (dfa.labels[order[i - 1]] != dfa.labels[order[i]]) {
+                groups += 1;
+            }
+            group[order[i]] = groups - 1;
+        }
+        for (bool split = true; split; ) {
+            split = false;
+            for (size_t cls = 1; cls <= dfa.classes_size; cls++) {
+                std::array<size_t, Capacity + 2> start{}; // 到达各组的状态在桶中的起点
+                for (size_t state = 0; state < size; state++) {
+                    start[group[dfa.next[state][cls]] + 1] += 1;
+                }
+                for (size_t g = 1; g <= groups; g++) {
+                    start[g] += start[g - 1];
+                }
+                for (size_t state = 0; state < size; state++) {
+                    order[start[group[dfa.next[state][cls]]]++] = state;
+                }
+                std::array<size_t, Capacity + 1> target{}; // 各组最近一次出现时到达的组
+                std::array<size_t, Capacity + 1> fresh{};  // 该组与该目标对应的新组
+                for (size_t g = 0; g < groups; g++) {
+                    target[g] = unnumbered;
+                }
+                std::array<size_t, Capacity + 1> refined{};
+                size_t count = 0;
+                for (size_t i = 0; i < size; i++) {
+                    const auto state = order[i];
+                    const auto g = group[state];
+                    const auto to = group[dfa.next[state][cls]];
+                    if (target[g] != to) {
+                        target[g] = to;
+                        fresh[g] = count++;
+                    }
+                    refined[state] = fresh[g];
+                }
+                if (count != groups) {
+                    split = true;
+                    groups = count;
+                }
+                group = refined;
+            }
+        }
+        return quotient(dfa, group);
+    }
+
+    // 合并两个状态机，对应union_dfa：字节类取两者的交，在两者的可达状态对上并行转换，标签按位并
+    template <size_t A, size_t CA, size_t B, size_t CB>
+    constexpr static fixed_dfa union_dfa(const fixed_dfa<A, CA>& lhs, const fixed_dfa<B, CB>& rhs) {
+        constexpr auto unnumbered = static_cast<size_t>(-1);
+        fixed_dfa result{};
+        std::array<std::array<size_t, 2>, Classes + 1> classes{}; // 新字节类在两者中所属的类
+        for (size_t byte = 0; byte < 256; byte++) {
+            const std::array<size_t, 2> pair{ lhs.encoder[byte], rhs.encoder[byte] };
+            if (pair[0] == 0 && pair[1] == 0) {
+                continue;
+            }
+            size_t cls = 1;
+            while (cls <= result.classes_size && (classes[cls][0] != pair[0] || classes[cls][1] != pair[1])) {
+                cls++;
+            }
+            if (cls > result.classes_size) {
+                if (cls > Classes) {
+                    throw std::length_error("fixed_dfa: too many byte classes");
+                }
+                result.classes_size = cls;
+                classes[cls] = pair;
+            }
+            result.encoder[byte] = static_cast<std::uint8_t>(cls);
+        }
+
+        const auto width = rhs.states_size + 1;
+        std::array<size_t, (A + 1) * (B + 1)> index{}; // 状态对(a, b)的新编号
+        for (auto& i : index) {
+            i = unnumbered;
+        }
+        std::array<std::array<size_t, 2>, Capacity + 1> pairs{};
+        index[0] = 0;
+        auto visit = [&](size_t a, size_t b) {
+            auto& i = index[a * width + b];
+            if (i == unnumbered) {
+                if (result.states_size == Capacity) {
+                    throw std::length_error("fixed_dfa: capacity exceeded");
+                }
+                i = ++result.states_size;
+                pairs[i] = { a, b };
+                result.labels[i] = lhs.labels[a] | rhs.labels[b];
+            }
+            return static_cast<state_type>(i);
+        };
+        result.initial_state = visit(lhs.initial_state, rhs.initial_state);
+        for (size_t i = 1; i <= result.states_size; i++) {
+            for (size_t cls = 1; cls <= result.classes_size; cls++) {
+                const auto to = visit(lhs.next[pairs[i][0]][classes[cls][0]], rhs.next[pairs[i][1]][classes[cls][1]]);
+                result.next[i][cls] = to;
+            }
+        }
+        return result;
+    }
+
+private:
+    template <class DFA, size_t... T, size_t... S>
+    constexpr static fixed_dfa of(std::index_sequence<T...>, std::index_sequence<S...>) {
+        using states = typename DFA::states::tuple;
+        using transitions = typename DFA::trans_table::tuple;
+        const std::array<fixed_transition, sizeof...(T)> list{ {
+            { index_of<DFA, typename std::tuple_element_t<T, transitions>::from_state>(std::index_sequence<S...>{}),
+              std::tuple_element_t<T, transitions>::cond,
+              index_of<DFA, typename std::tuple_element_t<T, transitions>::to_state>(std::index_sequence<S...>{}) }...
+        } };
+        const std::array<std::uint32_t, sizeof...(S)> labels{ { std::tuple_element_t<S, states>::label... } };
+        return from_transitions(list, index_of<DFA, typename DFA::initial_state>(std::index_sequence<S...>{}), labels);
+    }
+
+    // 类型层状态在DFA::states中的位置，空状态为fixed_transition::null
+    template <class DFA, class State, size_t... S>
+    constexpr static size_t index_of(std::index_sequence<S...>) {
+        size_t result = fixed_transition::null;
+        ((std::is_same_v<State, std::tuple_element_t<S, typename DFA::states::tuple>> && (result = S, true)) || ...);
+        return result;
+    }
+
+    // 堆排序，C++17的std::sort不是constexpr
+    template <size_t M, class Less>
+    constexpr static void sort(std::array<size_t, M>& a, size_t size, Less less) {
+        auto sift = [&](size_t root, size_t end) {
+            while (root * 2 + 1 < end) {
+                auto child = root * 2 + 1;
+                if (child + 1 < end && less(a[child], a[child + 1])) {
+                    child += 1;
+                }
+                if (!less(a[root], a[child])) {
+                    return;
+                }
+                const auto t = a[root];
+                a[root] = a[child];
+                a[child] = t;
+                root = child;
+            }
+        };
+        for (size_t i = size / 2; i-- > 0; ) {
+            sift(i, size);
+        }
+        for (size_t end = size; end-- > 1; ) {
+            const auto t = a[0];
+            a[0] = a[end];
+            a[end] = t;
+            sift(0, end);
+        }
+    }
+
+    // 只保留可达状态并重新编号
+    constexpr static fixed_dfa reachable(const fixed_dfa& dfa) {
+        std::array<size_t, Capacity + 1> group{};
+        for (size_t state = 0; state <= Capacity; state++) {
+            group[state] = state;
+        }
+        return quotient(dfa, group);
+    }
+
+    // 按划分合并状态，空状态所在的组为新的空状态，其余组按从初始状态出发的发现顺序编号
+    constexpr static fixed_dfa quotient(const fixed_dfa& dfa, const std::array<size_t, Capacity + 1>& group) {
+        constexpr auto unnumbered = static_cast<size_t>(-1);
+        std::array<size_t, Capacity + 1> number{};
+        std::array<size_t, Capacity + 1> representative{};
+        for (auto& n : number) {
+            n = unnumbered;
+        }
+        for (size_t state = dfa.states_size + 1; state-- > 0; ) {
+            representative[group[state]] = state; // 取各组中编号最小的状态
+        }
+        std::array<size_t, Capacity + 1> order{};
+        fixed_dfa result{};
+        result.encoder = dfa.encoder;
+        result.classes_size = dfa.classes_size;
+        number[group[0]] = 0;
+        auto visit = [&](size_t g) {
+            if (number[g] == unnumbered) {
+                number[g] = ++result.states_size;
+                order[number[g]] = g;
+                result.labels[number[g]] = dfa.labels[representative[g]];
+            }
+            return static_cast<state_type>(number[g]);
+        };
+        result.initial_state = visit(group[dfa.initial_state]);
+        for (size_t i = 1; i <= result.states_size; i++) {
+            const auto& row = dfa.next[representative[order[i]]];
+            for (size_t cls = 1; cls <= dfa.classes_size; cls++) {
+                const auto to = visit(group[row[cls]]);
+                result.next[i][cls] = to;
+            }
+        }
+        return result;
+    }
+};
+
+template <class T>
+struct is_fixed_dfa : std::false_type {};
+
+template <size_t Capacity, size_t Classes>
+struct is_fixed_dfa<fixed_dfa<Capacity, Classes>> : std::true_type {};
+
+// Spec提供constexpr static build()，返回fixed_dfa时，array_dfa_2d<Spec>从其值构造转换表。
+// fixed_dfa的字节类即字符集，之后的划分与类型层完全相同
+template <class Spec>
+struct array_dfa_source<Spec, std::enable_if_t<is_fixed_dfa<std::decay_t<decltype(Spec::build())>>::value>> {
+    using origin = Spec;
+
+    constexpr static auto value = Spec::build();
+
+    constexpr static auto charset_size = value.classes_size;
+
+    constexpr static auto states_size = value.states_size;
+
+    using state_type = least_uint_t<states_size>;
+
+    constexpr static auto make_char_encoder() {
+        std::array<std::uint16_t, 256> encoder{};
+        for (size_t byte = 0; byte < 256; byte++) {
+            encoder[byte] = value.encoder[byte];
+        }
+        return encoder;
+    }
+
+    constexpr static auto char_encoder = make_char_encoder();
+
+    constexpr static auto make_char_table() {
+        std::array<std::array<state_type, charset_size + 1>, states_size + 1> table{};
+        for (size_t state = 1; state <= states_size; state++) {
+            for (size_t cls = 1; cls <= charset_size; cls++) {
+                table[state][cls] = static_cast<state_type>(value.next[state][cls]);
+            }
+        }
+        return table;
+    }
+
+    constexpr static auto char_table = make_char_table();
+
+    constexpr static auto make_label_list() {
+        std::array<std::uint32_t, states_size + 1> list{};
+        for (size_t state = 1; state <= states_size; state++) {
+            list[state] = value.labels[state];
+        }
+        return list;
+    }
+
+    constexpr static auto label_list = make_label_list();
+
+    constexpr static auto initial_state = value.initial_state;
+};
+
+}
+
+#endif // !FIXED_DFA_H_
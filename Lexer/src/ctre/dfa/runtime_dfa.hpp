@@ -0,0 +1,364 @@
+#ifndef RUNTIME_DFA_H_
+#define RUNTIME_DFA_H_
+#include "array_dfa.hpp"
+#include <array>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <climits>
+#include <stdexcept>
+
+
+namespace cp {
+
+/* ---------------------运行期状态机--------------------- */
+// 与编译期的dfa、min_dfa、union_dfa、array_dfa_2d一一对应，但状态与转换都是普通的值，
+// 修改文法无需重新编译，构造的代价也与状态数成多项式关系，而不是模板实例化的数量。
+
+// 运行期的一个转换，状态以任意的非负整数编号
+struct runtime_transition {
+    size_t from;
+    char cond;
+    size_t to;
+};
+
+// 运行期的非确定状态机，条件为epsilon的转换是ε转换
+struct runtime_nfa {
+    constexpr static int epsilon = -1;
+
+    struct edge {
+        int cond; // 转换条件的字节值，或epsilon
+        size_t to;
+    };
+
+    std::vector<std::vector<edge>> edges;
+    std::vector<std::uint32_t> labels; // 各状态的标签，0为非接受状态
+    size_t initial_state = 0;
+
+    size_t add_state(std::uint32_t label = 0) {
+        edges.emplace_back();
+        labels.push_back(label);
+        return edges.size() - 1;
+    }
+
+    void add_edge(size_t from, int cond, size_t to) {
+        edges[from].push_back({ cond, to });
+    }
+};
+
+// 运行期的确定状态机，状态0为空状态，有效状态从1开始。
+// 所有构造函数都只保留从初始状态可达的状态，并按广度优先的发现顺序编号。
+struct runtime_dfa {
+    std::vector<std::array<std::uint32_t, 256>> next; // next[state][byte]为转换到达的状态
+    std::vector<std::uint32_t> labels;
+    std::uint32_t initial_state = 0;
+
+    size_t states_size() const {
+        return next.size() - 1;
+    }
+
+    // 由转换列表构造，对应dfa<init_trans_table<...>, Initial, Accepts>。
+    // 允许同一状态在同一字节上有多个转换，此时按子集构造确定化。labels按状态编号给出标签，缺省为0
+    static runtime_dfa from_transitions(const std::vector<runtime_transition>& transitions, size_t initial, const std::vector<std::uint32_t>& labels) {
+        runtime_nfa nfa;
+        auto ensure = [&](size_t state) {
+            while (nfa.edges.size() <= state) {
+                nfa.add_state();
+            }
+        };
+        ensure(initial);
+        for (const auto& t : transitions) {
+            ensure(t.from);
+            ensure(t.to);
+            nfa.add_edge(t.from, static_cast<unsigned char>(t.cond), t.to);
+        }
+        for (size_t state = 0; state < labels.size(); state++) {
+            ensure(state);
+            nfa.labels[state] = labels[state];
+        }
+        nfa.initial_state = initial;
+        return subset_construct(nfa);
+    }
+
+    // 子集构造。一个子集的标签为其中所有状态的标签按位并，与union_state一致
+    static runtime_dfa subset_construct(const runtime_nfa& nfa) {
+        runtime_dfa result;
+        result.next.push_back({});
+        result.labels.push_back(0);
+        std::map<std::vector<size_t>, std::uint32_t> index;
+        std::vector<std::vector<size_t>> subsets(1);
+
+        auto closure = [&](std::vector<size_t> states) {
+            std::vector<bool> seen(nfa.edges.size());
+            for (auto state : states) {
+                seen[state] = true;
+            }
+            for (size_t i = 0; i < states.size(); i++) {
+                for (const auto& e : nfa.edges[states[i]]) {
+                    if (e.cond == runtime_nfa::epsilon && !seen[e.to]) {
+                        seen[e.to] = true;
+                        states.push_back(e.to);
+                    }
+                }
+            }
+            std::sort(states.begin(), states.end());
+            return states;
+        };
+        auto intern = [&](std::vector<size_t> subset) -> std::uint32_t {
+            if (subset.empty()) {
+                return 0;
+            }
+            const auto [it, inserted] = index.emplace(subset, static_cast<std::uint32_t>(subsets.size()));
+            if (inserted) {
+                std::uint32_t label = 0;
+                for (auto state : subset) {
+                    label |= nfa.labels[state];
+                }
+                result.next.push_back({});
+                result.labels.push_back(label);
+                subsets.push_back(std::move(subset));
+            }
+            return it->second;
+        };
+
+        result.initial_state = intern(closure({ nfa.initial_state }));
+        std::array<std::vector<size_t>, 256> moves;
+        for (size_t i = 1; i < subsets.size(); i++) {
+            for (auto& move : moves) {
+                move.clear();
+            }
+            for (auto state : subsets[i]) {
+                for (const auto& e : nfa.edges[state]) {
+                    if (e.cond != runtime_nfa::epsilon) {
+                        moves[e.cond].push_back(e.to);
+                    }
+                }
+            }
+            for (size_t byte = 0; byte < 256; byte++) {
+                if (!moves[byte].empty()) {
+                    const auto to = intern(closure(moves[byte]));
+                    result.next[i][byte] = to;
+                }
+            }
+        }
+        return result;
+    }
+
+    // 最小化，对应min_dfa：反复按(所在组, 各字节转换到达的组)细分，直到划分不再变化。
+    // 初始划分按标签分组，标签不同的接受状态不会被合并
+    static runtime_dfa min_dfa(const runtime_dfa& dfa) {
+        std::vector<std::uint32_t> group(dfa.next.size());
+        size_t groups = 0;
+        {
+            std::map<std::uint32_t, std::uint32_t> by_label;
+            for (size_t state = 0; state < dfa.next.size(); state++) {
+                group[state] = by_label.emplace(dfa.labels[state], static_cast<std::uint32_t>(by_label.size())).first->second;
+            }
+            groups = by_label.size();
+        }
+        for (;;) {
+            std::map<std::vector<std::uint32_t>, std::uint32_t> signatures;
+            std::vector<std::uint32_t> refined(dfa.next.size());
+            std::vector<std::uint32_t> signature(257);
+            for (size_t state = 0; state < dfa.next.size(); state++) {
+                signature[0] = group[state];
+                for (size_t byte = 0; byte < 256; byte++) {
+                    signature[byte + 1] = group[dfa.next[state][byte]];
+                }
+                refined[state] = signatures.emplace(signature, static_cast<std::uint32_t>(signatures.size())).first->second;
+            }
+            group = std::move(refined);
+            if (signatures.size() == groups) { // 划分与上一轮相同时停止
+                break;
+            }
+            groups = signatures.size();
+        }
+        return quotient(dfa, group, groups);
+    }
+
+    // 合并两个状态机，对应union_dfa：在两者的可达状态对上并行转换，标签按位并
+    static runtime_dfa union_dfa(const runtime_dfa& lhs, const runtime_dfa& rhs) {
+        runtime_dfa result;
+        result.next.push_back({});
+        result.labels.push_back(0);
+        std::map<std::pair<std::uint32_t, std::uint32_t>, std::uint32_t> index { { { 0, 0 }, 0 } };
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs { { 0, 0 } };
+
+        auto intern = [&](std::pair<std::uint32_t, std::uint32_t> pair) {
+            const auto [it, inserted] = index.emplace(pair, static_cast<std::uint32_t>(pairs.size()));
+            if (inserted) {
+                result.next.push_back({});
+                result.labels.push_back(lhs.labels[pair.first] | rhs.labels[pair.second]);
+                pairs.push_back(pair);
+            }
+            return it->second;
+        };
+
+        result.initial_state = intern({ lhs.initial_state, rhs.initial_state });
+        for (size_t i = 1; i < pairs.size(); i++) {
+            const auto [a, b] = pairs[i];
+            for (size_t byte = 0; byte < 256; byte++) {
+                const auto to = intern({ lhs.next[a][byte], rhs.next[b][byte] });
+                result.next[i][byte] = to;
+            }
+        }
+        return result;
+    }
+
+private:
+    // 按划分合并状态，空状态所在的组为新的空状态，其余组按从初始状态出发的发现顺序编号
+    static runtime_dfa quotient(const runtime_dfa& dfa, const std::vector<std::uint32_t>& group, size_t groups) {
+        constexpr auto unnumbered = UINT32_MAX;
+        std::vector<std::uint32_t> number(groups, unnumbered);
+        std::vector<size_t> representative(groups);
+        for (size_t state = dfa.next.size(); state-- > 0; ) {
+            representative[group[state]] = state; // 取各组中编号最小的状态
+        }
+        runtime_dfa result;
+        number[group[0]] = 0;
+        result.next.push_back({});
+        result.labels.push_back(0);
+        std::vector<std::uint32_t> order { 0 };
+
+        auto visit = [&](std::uint32_t g) {
+            if (number[g] == unnumbered) {
+                number[g] = static_cast<std::uint32_t>(order.size());
+                order.push_back(g);
+                result.next.push_back({});
+                result.labels.push_back(dfa.labels[representative[g]]);
+            }
+            return number[g];
+        };
+
+        result.initial_state = visit(group[dfa.initial_state]);
+        for (size_t i = 1; i < order.size(); i++) {
+            const auto& row = dfa.next[representative[order[i]]];
+            for (size_t byte = 0; byte < 256; byte++) {
+                const auto to = visit(group[row[byte]]);
+                result.next[i][byte] = to;
+            }
+        }
+        return result;
+    }
+};
+
+/* ---------------------运行期转换表--------------------- */
+
+// 与array_dfa_2d布局相同的运行期转换表：字节类编码、按字节类为列的二维转换表与标签表。
+// Spec须提供static runtime_dfa build()，表在第一次使用时构造一次，之后所有实例共享。
+// MaxStates是编译期的状态数上限，决定状态的整数类型与FailureMemo的大小，构造出的状态机超过它时抛出std::length_error。
+// 哨兵、无回溯与自环在编译期未知，故保守地视为不存在，扫描器相应地退化为显式边界检查与带状态栈的匹配。
+template <class Spec, size_t MaxStates = UINT8_MAX>
+class runtime_array_dfa {
+public:
+    constexpr static auto states_size = MaxStates;
+
+    using state_type = least_uint_t<states_size>;
+
+    using cond_type = std::uint8_t;
+
+    struct self_loop {
+        std::uint8_t size;
+        std::array<std::array<std::uint8_t, 2>, 4> ranges;
+    };
+
+    struct table {
+        std::array<cond_type, 256> charset_encoder;
+        size_t classes_size;
+        size_t row_shift;                    // 每行占2^row_shift个元素，行首按行宽对齐
+        std::vector<state_type> trans_table; // 以字节类为列的转换表，行按状态排列
+        std::vector<std::uint32_t> label_list;
+        int initial_state;
+    };
+
+    // 字节类的划分与编号规则与array_dfa_2d::make_byte_classes相同
+    static table make_table(const runtime_dfa& dfa) {
+        if (dfa.states_size() > states_size) {
+            throw std::length_error("runtime_array_dfa: too many states");
+        }
+        table result{};
+        std::map<std::vector<std::uint32_t>, cond_type> classes;
+        std::vector<std::uint32_t> column(dfa.next.size());
+        std::vector<size_t> representatives(1); // 各类中最小的字节
+        for (size_t byte = 0; byte < 256; byte++) {
+            bool null = true;
+            for (size_t state = 1; state < dfa.next.size(); state++) {
+                column[state] = dfa.next[state][byte];
+                null = null && column[state] == 0;
+            }
+            if (null) {
+                continue;
+            }
+            if (classes.size() == UINT8_MAX && classes.find(column) == classes.end()) {
+                throw std::length_error("runtime_array_dfa: too many byte classes");
+            }
+            const auto cls = classes.emplace(column, static_cast<cond_type>(classes.size() + 1)).first->second;
+            if (cls == representatives.size()) {
+                representatives.push_back(byte);
+            }
+            result.charset_encoder[byte] = cls;
+        }
+        result.classes_size = classes.size();
+        while ((size_t(1) << result.row_shift) < result.classes_size + 1) {
+            result.row_shift += 1;
+        }
+        result.trans_table.resize(dfa.next.size() << result.row_shift);
+        for (size_t state = 1; state < dfa.next.size(); state++) {
+            for (size_t cond = 1; cond <= result.classes_size; cond++) {
+                result.trans_table[(state << result.row_shift) + cond] = static_cast<state_type>(dfa.next[state][representatives[cond]]);
+            }
+        }
+        result.label_list = dfa.labels;
+        result.initial_state = static_cast<int>(dfa.initial_state);
+        return result;
+    }
+
+    static const table& shared_table() {
+        static const table instance = make_table(Spec::build());
+        return instance;
+    }
+
+public:
+    constexpr static int null_state = 0;
+
+    constexpr static int sentinel = -1;
+
+    constexpr static bool backtrack_free = false;
+
+    constexpr static std::array<self_loop, 1> self_loops{};
+
+    runtime_array_dfa()
+        : m_encoder(shared_table().charset_encoder.data()), m_trans(shared_table().trans_table.data()),
+          m_labels(shared_table().label_list.data()), m_shift(shared_table().row_shift), initial_state(shared_table().initial_state) {}
+
+    cond_type encode(char c) const {
+        return m_encoder[static_cast<unsigned char>(c)];
+    }
+
+    int trans(int state, char cond) const {
+        return m_trans[(static_cast<size_t>(state) << m_shift) + encode(cond)];
+    }
+
+    std::uint32_t label(int state) const {
+        return m_labels[state];
+    }
+
+    constexpr static int row(int state) {
+        return state;
+    }
+
+private:
+    const cond_type* m_encoder;
+    const state_type* m_trans;
+    const std::uint32_t* m_labels;
+    size_t m_shift;
+
+public:
+    int initial_state;
+};
+
+}
+
+#endif // !RUNTIME_DFA_H_
@@ -0,0 +1,131 @@
+#ifndef SHUFFLE_DFA_H_
+#define SHUFFLE_DFA_H_
+#include "array_dfa.hpp"
+#include <array>
+#include <cstdint>
+#include <type_traits>
+// MSVC没有__SSSE3__：Lexer.vcxproj仅在x64配置以/arch:AVX编译，由__AVX__启用；Win32配置走标量路径
+#if defined(__SSSE3__) || defined(__AVX__)
+#include <tmmintrin.h>
+#define SHUFFLE_DFA_SSSE3
+#endif
+
+
+namespace cp {
+
+template <class DFA>
+struct shuffle_dfa { // 至多16个状态（含空状态）的状态机，用字节洗牌指令完成转换
+    // type-traits
+    using origin = array_dfa_2d<DFA>;
+
+    constexpr static auto charset_size = origin::charset_size;
+
+    constexpr static auto states_size = origin::states_size;
+
+    constexpr static auto classes_size = origin::classes_size;
+
+    static_assert(states_size < 16, "shuffle_dfa holds at most 15 states besides the null state");
+
+    // 一个字节类的转换：第state个字节是state经过该类后到达的状态
+    struct alignas(16) shuffle_row {
+        std::array<std::uint8_t, 16> next;
+    };
+
+public:
+    // 状态编号只占低4位。pshufb只看索引的低4位与最高位，第4位用来标记自环状态，不影响转换
+    constexpr static std::uint8_t state_mask = 0x0F;
+
+    constexpr static std::uint8_t loop_flag = 0x10;
+
+    constexpr static auto make_shuffles() {
+        std::array<shuffle_row, classes_size + 1> rows{};
+        for (size_t cond = 1; cond <= classes_size; cond++) {
+            for (size_t state = 1; state <= states_size; state++) {
+                const auto next = origin::trans_table[state][cond];
+                rows[cond].next[state] = static_cast<std::uint8_t>(next | (origin::self_loops[next].size != 0 ? loop_flag : 0));
+            }
+        }
+        return rows;
+    }
+
+    // 按字节类排列的洗牌向量，类0全为空状态；到达自环状态的转换带有loop_flag
+    constexpr static auto shuffles = make_shuffles();
+
+public:
+    // 状态编号与array_dfa_2d相同
+    constexpr static auto null_state = origin::null_state;
+
+    constexpr static auto initial_state = origin::initial_state;
+
+    constexpr static int sentinel = origin::sentinel;
+
+    constexpr static bool backtrack_free = origin::backtrack_free;
+
+    constexpr static auto self_loops = origin::self_loops;
+
+    constexpr static auto encode(char c) {
+        return origin::encode(c);
+    }
+
+    // 洗牌向量只取决于输入字节，可以提前读取；状态到状态的依赖链上只有一条pshufb，没有依赖于状态的内存读取
+    static int trans(int state, char cond) {
+#if defined(SHUFFLE_DFA_SSSE3)
+        const auto row = _mm_load_si128(reinterpret_cast<const __m128i*>(shuffles[encode(cond)].next.data()));
+        return _mm_cvtsi128_si32(_mm_shuffle_epi8(row, _mm_cvtsi32_si128(state))) & state_mask;
+#else
+        return shuffles[encode(cond)].next[state] & state_mask;
+#endif
+    }
+
+    // 从state出发在[first, last)上连续转换，下一字节转入空状态或刚进入自环状态（交给SelfLoop成段跳过）时停下，
+    // 返回停下的位置，state更新为停下时的状态。状态在整个循环中留在向量寄存器里，
+    // 每字节只有一次按字节类的读取与一条pshufb，取出到通用寄存器的值只用于判断是否停下，不在依赖链上
+    static const char* run(int& state, const char* first, const char* last) {
+#if defined(SHUFFLE_DFA_SSSE3)
+        auto current = _mm_cvtsi32_si128(state);
+        while (first != last) {
+            const auto row = _mm_load_si128(reinterpret_cast<const __m128i*>(shuffles[encode(*first)].next.data()));
+            const auto next = _mm_shuffle_epi8(row, current);
+            const auto tagged = _mm_cvtsi128_si32(next);
+            if ((tagged & state_mask) == null_state) {
+                break;
+            }
+            current = next;
+            ++first;
+            if (tagged & loop_flag) {
+                break;
+            }
+        }
+        state = _mm_cvtsi128_si32(current) & state_mask;
+#else
+        while (first != last) {
+            const auto tagged = shuffles[encode(*first)].next[state];
+            if ((tagged & state_mask) == null_state) {
+                break;
+            }
+            state = tagged & state_mask;
+            ++first;
+            if (tagged & loop_flag) {
+                break;
+            }
+        }
+#endif
+        return first;
+    }
+
+    constexpr static auto label(int state) {
+        return origin::label(state);
+    }
+
+    constexpr static int row(int state) {
+        return state;
+    }
+};
+
+// 状态足够少时选用shuffle_dfa，否则选用array_dfa_2d
+template <class DFA>
+using small_dfa = std::conditional_t<(array_dfa_2d<DFA>::states_size < 16), shuffle_dfa<DFA>, array_dfa_2d<DFA>>;
+
+}
+
+#endif // !SHUFFLE_DFA_H_
@@ -0,0 +1,273 @@
+#ifndef RUNTIME_REGEX_H_
+#define RUNTIME_REGEX_H_
+#include "../dfa/runtime_dfa.hpp"
+#include <bitset>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+
+namespace cp {
+
+// 一条词法规则：匹配pattern的词素带有标签label
+struct regex_rule {
+    std::string_view pattern;
+    std::uint32_t label;
+};
+
+// 运行期的正则表达式解析器，按Thompson构造将规则编译进runtime_nfa。
+// 支持的语法：连接、'|'、'*'、'+'、'?'、圆括号、'.'（除'\n'外的任意字节）、
+// 字符类[a-z]与[^...]、转义\d \w \s \n \t \r \f \v \0 \xHH，其余转义字符表示其本身。
+// 语法错误时抛出std::invalid_argument，消息中带有出错的位置。
+class runtime_regex_parser {
+public:
+    using byte_set = std::bitset<256>;
+
+    // 将规则编译进nfa，返回规则的起始状态，规则的接受状态带有label
+    static size_t parse(runtime_nfa& nfa, std::string_view pattern, std::uint32_t label) {
+        runtime_regex_parser parser(nfa, pattern);
+        const auto result = parser.parse_unite();
+        if (parser.m_pos != pattern.size()) { // 只有多余的')'会停在这里
+            parser.fail("unmatched ')'");
+        }
+        nfa.labels[result.accept] = label;
+        return result.start;
+    }
+
+private:
+    // Thompson构造的片段，只有一个入口与一个出口
+    struct fragment {
+        size_t start;
+        size_t accept;
+    };
+
+    runtime_regex_parser(runtime_nfa& nfa, std::string_view pattern) : m_nfa(nfa), m_pattern(pattern) {}
+
+    [[noreturn]] void fail(const char* message) const {
+        throw std::invalid_argument(std::string("regex: ") + message + " at " + std::to_string(m_pos) + " in \"" + std::string(m_pattern) + "\"");
+    }
+
+    bool done() const { return m_pos == m_pattern.size(); }
+
+    char peek() const { return m_pattern[m_pos]; }
+
+    fragment epsilon() {
+        const auto start = m_nfa.add_state();
+        const auto accept = m_nfa.add_state();
+        m_nfa.add_edge(start, runtime_nfa::epsilon, accept);
+        return { start, accept };
+    }
+
+    fragment bytes(const byte_set& set) {
+        const auto start = m_nfa.add_state();
+        const auto accept = m_nfa.add_state();
+        for (int byte = 0; byte < 256; byte++) {
+            if (set[byte]) {
+                m_nfa.add_edge(start, byte, accept);
+            }
+        }
+        return { start, accept };
+    }
+
+    // unite := concat ('|' concat)*
+    fragment parse_unite() {
+        auto result = parse_concat();
+        if (done() || peek() != '|') {
+            return result;
+        }
+        const auto start = m_nfa.add_state();
+        const auto accept = m_nfa.add_state();
+        for (;;) {
+            m_nfa.add_edge(start, runtime_nfa::epsilon, result.start);
+            m_nfa.add_edge(result.accept, runtime_nfa::epsilon, accept);
+            if (done() || peek() != '|') {
+                return { start, accept };
+            }
+            m_pos += 1;
+            result = parse_concat();
+        }
+    }
+
+    // concat := repeat*，空连接匹配空串
+    fragment parse_concat() {
+        auto result = epsilon();
+        while (!done() && peek() != '|' && peek() != ')') {
+            const auto next = parse_repeat();
+            m_nfa.add_edge(result.accept, runtime_nfa::epsilon, next.start);
+            result.accept = next.accept;
+        }
+        return result;
+    }
+
+    // repeat := atom ('*' | '+' | '?')*
+    fragment parse_repeat() {
+        auto result = parse_atom();
+        while (!done() && (peek() == '*' || peek() == '+' || peek() == '?')) {
+            const auto op = peek();
+            m_pos += 1;
+            const auto start = m_nfa.add_state();
+            const auto accept = m_nfa.add_state();
+            m_nfa.add_edge(start, runtime_nfa::epsilon, result.start);
+            m_nfa.add_edge(result.accept, runtime_nfa::epsilon, accept);
+            if (op != '+') { // 可以跳过
+                m_nfa.add_edge(start, runtime_nfa::epsilon, accept);
+            }
+            if (op != '?') { // 可以重复
+                m_nfa.add_edge(result.accept, runtime_nfa::epsilon, result.start);
+            }
+            result = { start, accept };
+        }
+        return result;
+    }
+
+    // atom := '(' unite ')' | '[' class ']' | '.' | '\' escape | byte
+    fragment parse_atom() {
+        const auto c = peek();
+        m_pos += 1;
+        switch (c) {
+        case '(': {
+            const auto result = parse_unite();
+            if (done()) {
+                fail("missing ')'");
+            }
+            m_pos += 1;
+            return result;
+        }
+        case '[':
+            return bytes(parse_class());
+        case '.':
+            return bytes(byte_set().set().reset('\n'));
+        case '\\':
+            return bytes(parse_escape());
+        case '*': case '+': case '?':
+            m_pos -= 1;
+            fail("nothing to repeat");
+        case ']':
+            m_pos -= 1;
+            fail("unmatched ']'");
+        default:
+            return bytes(byte_set().set(static_cast<unsigned char>(c)));
+        }
+    }
+
+    // 字符类，']'紧跟在'['或'[^'之后时表示其本身，'-'在首尾时表示其本身
+    byte_set parse_class() {
+        byte_set result;
+        const bool negate = !done() && peek() == '^';
+        m_pos += negate;
+        bool first = true;
+        while (!done() && (first || peek() != ']')) {
+            first = false;
+            const auto low = parse_class_member();
+            if (low.count() == 1 && m_pos + 1 < m_pattern.size() && peek() == '-' && m_pattern[m_pos + 1] != ']') {
+                m_pos += 1;
+                const auto high = parse_class_member();
+                if (high.count() != 1) {
+                    fail("invalid range");
+                }
+                const auto lo = lowest(low);
+                const auto hi = lowest(high);
+                if (lo > hi) {
+                    fail("invalid range");
+                }
+                for (auto byte = lo; byte <= hi; byte++) {
+                    result.set(byte);
+                }
+            } else {
+                result |= low;
+            }
+        }
+        if (done()) {
+            fail("missing ']'");
+        }
+        m_pos += 1;
+        return negate ? ~result : result;
+    }
+
+    byte_set parse_class_member() {
+        const auto c = peek();
+        m_pos += 1;
+        if (c == '\\') {
+            return parse_escape();
+        }
+        return byte_set().set(static_cast<unsigned char>(c));
+    }
+
+    byte_set parse_escape() {
+        if (done()) {
+            fail("trailing '\\'");
+        }
+        const auto c = peek();
+        m_pos += 1;
+        byte_set result;
+        switch (c) {
+        case 'd':
+            for (int byte = '0'; byte <= '9'; byte++) result.set(byte);
+            return result;
+        case 'w':
+            for (int byte = '0'; byte <= '9'; byte++) result.set(byte);
+            for (int byte = 'a'; byte <= 'z'; byte++) result.set(byte);
+            for (int byte = 'A'; byte <= 'Z'; byte++) result.set(byte);
+            return result.set('_');
+        case 's':
+            return result.set(' ').set('\t').set('\n').set('\r').set('\f').set('\v');
+        case 'n': return result.set('\n');
+        case 't': return result.set('\t');
+        case 'r': return result.set('\r');
+        case 'f': return result.set('\f');
+        case 'v': return result.set('\v');
+        case '0': return result.set(0);
+        case 'x': {
+            int value = 0;
+            for (int i = 0; i < 2; i++) {
+                const auto digit = done() ? -1 : hex(peek());
+                if (digit < 0) {
+                    fail("invalid \\x escape");
+                }
+                value = value * 16 + digit;
+                m_pos += 1;
+            }
+            return result.set(value);
+        }
+        default:
+            return result.set(static_cast<unsigned char>(c));
+        }
+    }
+
+    static int hex(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    static int lowest(const byte_set& set) {
+        int byte = 0;
+        while (!set[byte]) {
+            byte++;
+        }
+        return byte;
+    }
+
+private:
+    runtime_nfa& m_nfa;
+    std::string_view m_pattern;
+    size_t m_pos = 0;
+};
+
+// 将一组规则编译为最小的确定状态机。各规则共享一个初始状态，
+// 一个词素同时匹配多条规则时标签按位并，与union_dfa合并编译期状态机的结果一致
+inline runtime_dfa make_runtime_dfa(const std::vector<regex_rule>& rules) {
+    runtime_nfa nfa;
+    nfa.initial_state = nfa.add_state();
+    for (const auto& rule : rules) {
+        const auto start = runtime_regex_parser::parse(nfa, rule.pattern, rule.label);
+        nfa.add_edge(nfa.initial_state, runtime_nfa::epsilon, start);
+    }
+    return runtime_dfa::min_dfa(runtime_dfa::subset_construct(nfa));
+}
+
+}
+
+#endif // !RUNTIME_REGEX_H_
@@ -0,0 +1,68 @@
+#ifndef UNITTEST_H_
+#define UNITTEST_H_
+#include "../src/ctre/dfa/fixed_dfa.hpp"
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <filesystem>
+
+// 图3-36的转换以整数编号，只有E是接受状态，最小化后A与C合并
+constexpr auto DragonTransitions = std::array<cp::fixed_transition, 10>{ {
+    { 0, 'a', 1 }, { 0, 'b', 2 }, { 1, 'a', 1 }, { 1, 'b', 3 }, { 2, 'a', 1 },
+    { 2, 'b', 2 }, { 3, 'a', 1 }, { 3, 'b', 4 }, { 4, 'a', 1 }, { 4, 'b', 2 } } };
+struct FixedSpec {
+    constexpr static auto build() {
+        return cp::fixed_dfa<8>::min_dfa(cp::fixed_dfa<8>::from_transitions(DragonTransitions, 0, std::array<std::uint32_t, 5>{ 0, 0, 0, 0, 1 }));
+    }
+};
+
+// 多个词素的带标签状态机：标识符[ifx][ifx01]*(1)、关键字if(2)、数字[01]+(\.[01]+)?(3)、空白(4)、<(5)与<=(6)。
+// "0."之后须再有数字才能接受，故需要回溯；标识符、数字与空白的状态带有自环
+constexpr auto TokenTransitions = std::array<cp::fixed_transition, 31>{ {
+    { 0, 'i', 1 }, { 0, 'f', 3 }, { 0, 'x', 3 }, { 0, '0', 4 }, { 0, '1', 4 }, { 0, ' ', 5 }, { 0, '<', 6 },
+    { 1, 'f', 2 }, { 1, 'i', 3 }, { 1, 'x', 3 }, { 1, '0', 3 }, { 1, '1', 3 },
+    { 2, 'i', 3 }, { 2, 'f', 3 }, { 2, 'x', 3 }, { 2, '0', 3 }, { 2, '1', 3 },
+    { 3, 'i', 3 }, { 3, 'f', 3 }, { 3, 'x', 3 }, { 3, '0', 3 }, { 3, '1', 3 },
+    { 4, '0', 4 }, { 4, '1', 4 }, { 4, '.', 7 }, { 7, '0', 8 }, { 7, '1', 8 }, { 8, '0', 8 }, { 8, '1', 8 },
+    { 5, ' ', 5 }, { 6, '=', 9 } } };
+struct TokenSpec {
+    constexpr static auto build() {
+        return cp::fixed_dfa<10>::min_dfa(cp::fixed_dfa<10>::from_transitions(TokenTransitions, 0, std::array<std::uint32_t, 10>{ 0, 1, 2, 1, 3, 4, 5, 0, 3, 6 }));
+    }
+};
+
+// 去掉小数部分后无需回溯，扫描器改走不带状态栈的匹配循环
+struct StacklessSpec {
+    constexpr static auto build() {
+        std::array<cp::fixed_transition, 26> transitions{};
+        size_t size = 0;
+        for (const auto& t : TokenTransitions) {
+            if (t.cond != '.' && t.from != 7 && t.from != 8) {
+                transitions[size++] = t;
+            }
+        }
+        return cp::fixed_dfa<10>::min_dfa(cp::fixed_dfa<10>::from_transitions(transitions, 0, std::array<std::uint32_t, 10>{ 0, 1, 2, 1, 3, 4, 5, 0, 3, 6 }));
+    }
+};
+
+// 运行期测试生成的源文件，定义在unittest_scanner.cpp中
+std::filesystem::path temp_path(const std::string& name);
+
+void write_file(const std::filesystem::path& path, const std::string& text);
+
+std::string generate(std::mt19937& rng, size_t bytes);
+
+// 运行期测试的入口，由unittest_dfa.cpp的main调用，失败时向cerr报告原因并返回false
+bool unittest_scanner();
+
+bool unittest_runtime();
+
+bool unittest_parallel();
+
+bool unittest_cache();
+
+// 性能测试的入口，以--bench运行时调用，结果输出到cout
+void benchmark_scanner();
+
+#endif // !UNITTEST_H_
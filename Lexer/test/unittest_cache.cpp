@@ -0,0 +1,107 @@
+#include "unittest.hpp"
+#include "../src/ctre/dfa/array_dfa.hpp"
+#include "../src/MappedScanner.hpp"
+#include "../src/CachedScanner.hpp"
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace cp;
+using namespace std;
+
+namespace {
+
+using TokenDFA = array_dfa_2d<TokenSpec>;
+using StacklessDFA = array_dfa_2d<StacklessSpec>;
+
+// test cached-scanner，无论是否命中缓存，词素与文本都应与MappedScanner逐个相同；
+// 返回命中缓存的源文件数量，不同时返回-1
+template <class ArrayDFA, class... Paths>
+int cached_hits(const fs::path& cache, const Paths&... paths) {
+    MappedScanner<ArrayDFA> mapped({ paths... });
+    CachedScanner<ArrayDFA> cached({ paths... }, cache);
+    for (auto expected = mapped.nextLexeme(); expected.length != 0; expected = mapped.nextLexeme()) {
+        const auto actual = cached.nextLexeme();
+        if (actual.label != expected.label || actual.source != expected.source || actual.offset != expected.offset
+            || actual.length != expected.length || cached.view(actual) != mapped.view(expected)) {
+            return -1;
+        }
+    }
+    return cached.nextLexeme().length == 0 && cached.failures() == mapped.failures() ? static_cast<int>(cached.hits()) : -1;
+}
+
+// 缓存目录中唯一的缓存文件
+fs::path cache_entry(const fs::path& cache) {
+    vector<fs::path> entries;
+    for (const auto& entry : fs::directory_iterator(cache)) {
+        entries.push_back(entry.path());
+    }
+    return entries.size() == 1 ? entries[0] : fs::path();
+}
+
+// 改写缓存文件的内容，模拟损坏或伪造的缓存
+template <class Edit>
+void corrupt(const fs::path& entry, Edit edit) {
+    string data;
+    {
+        ifstream file(entry, ios::binary);
+        data.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    }
+    edit(data);
+    write_file(entry, data);
+}
+
+// 长度编码位于缓存文件的末尾：截去末字节、改变末个长度的值或使其缺少结尾字节，都须被find拒绝
+bool test_corruption(const fs::path& cache, const fs::path& path) {
+    const auto edits = {
+        +[](string& data) { data.pop_back(); },
+        +[](string& data) { data.back() ^= 0x01; },
+        +[](string& data) { data.back() |= static_cast<char>(0x80); },
+    };
+    for (const auto edit : edits) {
+        const auto entry = cache_entry(cache);
+        if (entry.empty()) {
+            return false;
+        }
+        corrupt(entry, edit);
+        if (cached_hits<TokenDFA>(cache, path) != 0 || cached_hits<TokenDFA>(cache, path) != 1) { // 拒绝后重新写入
+            return false;
+        }
+    }
+    return true;
+}
+
+bool test_cache(mt19937& rng) {
+    const auto cache = temp_path("cache");
+    const auto path = temp_path("cache_source");
+    const auto other = temp_path("cache_other");
+    const auto missing = temp_path("cache_missing");
+    fs::remove_all(cache);
+    write_file(path, generate(rng, 20000));
+    write_file(other, generate(rng, 3000));
+    // 首次扫描写入缓存，再次扫描全部命中；编辑源文件后其缓存不再命中；状态机不同时指纹不同
+    auto result = cached_hits<TokenDFA>(cache, path) == 0 && cached_hits<TokenDFA>(cache, path) == 1
+        && cached_hits<TokenDFA>(cache, other, missing, path) == 1 && cached_hits<TokenDFA>(cache, other, missing, path) == 2
+        && cached_hits<StacklessDFA>(cache, path) == 0 && cached_hits<StacklessDFA>(cache, path) == 1;
+    write_file(path, generate(rng, 20000));
+    result = result && cached_hits<TokenDFA>(cache, path) == 0 && cached_hits<TokenDFA>(cache, path) == 1;
+    fs::remove_all(cache);
+    result = result && cached_hits<TokenDFA>(cache, path) == 0 && test_corruption(cache, path);
+    fs::remove_all(cache);
+    for (const auto& source : { path, other }) {
+        fs::remove(source);
+    }
+    if (!result) {
+        cerr << "CachedScanner disagrees with MappedScanner or misuses a cache entry" << endl;
+    }
+    return result;
+}
+
+}
+
+bool unittest_cache() {
+    mt19937 rng(11);
+    return test_cache(rng);
+}
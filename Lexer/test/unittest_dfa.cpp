@@ -2,8 +2,14 @@
 #include "../src/ctre/dfa/min_dfa.hpp"
 #include "../src/ctre/dfa/dfa_utility.hpp"
 #include "../src/ctre/dfa/array_dfa.hpp"
+#include "../src/ctre/dfa/direct_dfa.hpp"
+#include "../src/ctre/dfa/shuffle_dfa.hpp"
+#include "../src/ctre/dfa/comb_dfa.hpp"
+#include "../src/ctre/dfa/fixed_dfa.hpp"
+#include "unittest.hpp"
 #include <iostream>
 #include <typeinfo>
+#include <string_view>
 
 using namespace cp;
 using namespace std;
@@ -142,8 +148,160 @@ static_assert(is_same_v<IndexDFA::states, state_group<Ai, Bi, Ci, Di, Ei>>);
 static_assert(is_same_v<IndexDFA::trans<Ai, 'b'>, Ci>);
 static_assert(is_same_v<IndexDFA::trans<Ei, 'b'>, Ci>);
 
+// test array-dfa
+using ArrayDFA = array_dfa<DFA>;
+static_assert(is_same_v<ArrayDFA::state_type, std::uint8_t>);
+static_assert(is_same_v<ArrayDFA::cond_type, std::uint8_t>);
+static_assert(alignof(ArrayDFA::trans_row) == 4 && sizeof(ArrayDFA::trans_row) == 4); // 3字节的行对齐到4字节
+static_assert(ArrayDFA::classes_size == 2);
+static_assert(ArrayDFA::encode('a') == 1 && ArrayDFA::encode('b') == 2);
+static_assert(ArrayDFA::encode('c') == 0 && ArrayDFA::encode('\x7f') == 0 && ArrayDFA::encode('\xff') == 0);
+static_assert(ArrayDFA::initial_state == 1);
+static_assert(ArrayDFA::trans(ArrayDFA::initial_state, 'a') == 2); // A -a-> B
+static_assert(ArrayDFA::trans(ArrayDFA::initial_state, 'b') == 3); // A -b-> C
+static_assert(ArrayDFA::trans(4, 'b') == 5);                       // D -b-> E
+static_assert(ArrayDFA::trans(5, 'c') == ArrayDFA::null_state);
+static_assert(ArrayDFA::trans(ArrayDFA::null_state, 'a') == ArrayDFA::null_state);
+static_assert(is_same_v<least_uint_t<255>, std::uint8_t>);
+static_assert(is_same_v<least_uint_t<256>, std::uint16_t>);
+static_assert(is_same_v<least_uint_t<65536>, std::uint32_t>);
+using La = state<std::index_sequence<1>>;
+using Lb = state<std::index_sequence<2>, 7>;
+using LabelDFA = array_dfa<dfa<init_trans_table<transition<La, 'x', Lb>>, La, state_group<Lb>>>;
+static_assert(LabelDFA::trans(1, 'x') == 2);                      // 唯一的转换
+static_assert(LabelDFA::label(2) == 7 && LabelDFA::label(1) == 0); // 标签与转换表的状态编号一致
 
+// test fixed-dfa
+constexpr auto FixedDragon = fixed_dfa<8>::of<DFA>();
+static_assert(FixedDragon.states_size == 5 && FixedDragon.classes_size == 2);
+static_assert(FixedDragon.initial_state == ArrayDFA::initial_state);
+static_assert(FixedDragon.trans(1, 'a') == ArrayDFA::trans(1, 'a') && FixedDragon.trans(4, 'b') == ArrayDFA::trans(4, 'b'));
+static_assert(FixedDragon.trans(1, 'c') == 0);
 
-int main() {
+// 图3-36的转换以整数编号，见unittest.hpp
+using FixedDFA = array_dfa_2d<FixedSpec>;
+static_assert(FixedDFA::states_size == 4 && FixedDFA::classes_size == 2);
+static_assert(FixedDFA::trans(FixedDFA::trans(FixedDFA::trans(FixedDFA::initial_state, 'a'), 'b'), 'b') == 4);
+static_assert(FixedDFA::label(4) == 1 && FixedDFA::label(FixedDFA::initial_state) == 0);
+static_assert(FixedDFA::trans(FixedDFA::initial_state, 'b') == FixedDFA::initial_state); // C并入了A
+static_assert(FixedDFA::trans(4, 'c') == FixedDFA::null_state && FixedDFA::sentinel == 0);
+
+// 两个状态机的合并
+struct FixedUnionSpec {
+    constexpr static auto build() {
+        constexpr auto lhs = fixed_dfa<2>::from_transitions(std::array<fixed_transition, 1>{ { { 0, 'a', 1 } } }, 0, std::array<std::uint32_t, 2>{ 0, 1 });
+        constexpr auto rhs = fixed_dfa<2>::from_transitions(std::array<fixed_transition, 2>{ { { 0, 'a', 1 }, { 0, 'b', 1 } } }, 0, std::array<std::uint32_t, 2>{ 0, 2 });
+        return fixed_dfa<4>::min_dfa(fixed_dfa<4>::union_dfa(lhs, rhs));
+    }
+};
+using FixedUnionDFA = array_dfa_2d<FixedUnionSpec>;
+static_assert(FixedUnionDFA::states_size == 3 && FixedUnionDFA::classes_size == 2);
+static_assert(FixedUnionDFA::label(FixedUnionDFA::trans(FixedUnionDFA::initial_state, 'a')) == 3);
+static_assert(FixedUnionDFA::label(FixedUnionDFA::trans(FixedUnionDFA::initial_state, 'b')) == 2);
+
+// test backends
+// 多个词素的带标签状态机，见unittest.hpp
+using TokenDFA = array_dfa_2d<TokenSpec>;
+static_assert(TokenDFA::states_size == 10 && TokenDFA::classes_size == 8); // i、f、x、[01]、' '、<、=、.
+static_assert(TokenDFA::label(TokenDFA::trans(TokenDFA::trans(TokenDFA::initial_state, 'i'), 'f')) == 2);
+static_assert(TokenDFA::label(TokenDFA::trans(TokenDFA::trans(TokenDFA::initial_state, '0'), '.')) == 0);
+static_assert(!TokenDFA::backtrack_free && TokenDFA::sentinel == 0);
+static_assert(TokenDFA::self_loops[TokenDFA::trans(TokenDFA::initial_state, 'x')].size == 4); // [01]、f、i、x
+static_assert(TokenDFA::self_loops[TokenDFA::trans(TokenDFA::initial_state, ' ')].size == 1);
+static_assert(TokenDFA::self_loops[TokenDFA::initial_state].size == 0);
+static_assert(array_dfa_2d<StacklessSpec>::backtrack_free && array_dfa_2d<StacklessSpec>::states_size == 8);
+
+// 各后端与array_dfa_2d的状态编号之间的映射
+struct SameState {
+    constexpr int operator()(int state) const { return state; }
+};
+template <class OffsetDFA>
+struct OffsetState {
+    constexpr int operator()(int state) const { return static_cast<int>(OffsetDFA::rows[state] * OffsetDFA::row_width); }
+};
+
+// 映射到同一状态后，每个状态在全部256个字节上的转换、标签与自环都应与array_dfa_2d一致
+template <class Backend, class Map>
+constexpr bool same_as_2d(Map map) {
+    for (int state = 0; state <= static_cast<int>(TokenDFA::states_size); state++) {
+        if (Backend::label(map(state)) != TokenDFA::label(state)) {
+            return false;
+        }
+        const auto& loop = Backend::self_loops[Backend::row(map(state))];
+        const auto& expected = TokenDFA::self_loops[state];
+        if (loop.size != expected.size) {
+            return false;
+        }
+        for (size_t i = 0; i < loop.size; i++) {
+            if (loop.ranges[i][0] != expected.ranges[i][0] || loop.ranges[i][1] != expected.ranges[i][1]) {
+                return false;
+            }
+        }
+        for (int byte = 0; byte < 256; byte++) {
+            if (Backend::trans(map(state), static_cast<char>(byte)) != map(TokenDFA::trans(state, static_cast<char>(byte)))) {
+                return false;
+            }
+        }
+    }
+    return Backend::initial_state == map(TokenDFA::initial_state) && Backend::null_state == map(TokenDFA::null_state)
+        && Backend::sentinel == TokenDFA::sentinel && Backend::backtrack_free == TokenDFA::backtrack_free;
+}
+
+// test array-dfa-1d
+using OffsetTokenDFA = array_dfa_1d<TokenSpec>;
+static_assert(OffsetTokenDFA::row_width == 16); // 9列取整到2的幂
+static_assert(same_as_2d<OffsetTokenDFA>(OffsetState<OffsetTokenDFA>{}));
+
+// test direct-dfa
+static_assert(same_as_2d<direct_dfa<TokenSpec>>(SameState{}));
+
+// test shuffle-dfa，转换使用洗牌指令，不是constexpr，在main中检查
+static_assert(is_same_v<small_dfa<TokenSpec>, shuffle_dfa<TokenSpec>>);
+static_assert(alignof(shuffle_dfa<TokenSpec>::shuffle_row) == 16);
+
+// test comb-dfa
+static_assert(same_as_2d<comb_dfa<TokenSpec>>(SameState{}));
+
+// shuffle_dfa::run应停在逐字节转换转入空状态之前，或刚进入自环状态之后
+bool run_as_2d(const char* text) {
+    using Shuffle = shuffle_dfa<TokenSpec>;
+    const auto last = text + char_traits<char>::length(text);
+    for (auto first = text; first != last; first++) {
+        int state = Shuffle::initial_state;
+        int expected = TokenDFA::initial_state;
+        auto stop = first;
+        while (stop != last && TokenDFA::trans(expected, *stop) != TokenDFA::null_state) {
+            expected = TokenDFA::trans(expected, *stop++);
+            if (TokenDFA::self_loops[expected].size != 0) {
+                break;
+            }
+        }
+        if (Shuffle::run(state, first, last) != stop || state != expected) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string_view(argv[1]) == "--bench") {
+        benchmark_scanner();
+        return 0;
+    }
     auto& encoder =  array_dfa<IndexDFA>::charset_encoder;
+    if (!same_as_2d<shuffle_dfa<TokenSpec>>(SameState{})) {
+        cerr << "shuffle_dfa disagrees with array_dfa_2d" << endl;
+        return 1;
+    }
+    for (const auto text : { "if x1 <= 0.1", "iff0.<=", "  \xFF" "0.", "1010.01.1<<=", "" }) {
+        if (!run_as_2d(text)) {
+            cerr << "shuffle_dfa::run disagrees with array_dfa_2d on \"" << text << '"' << endl;
+            return 1;
+        }
+    }
+    if (!unittest_scanner() || !unittest_runtime() || !unittest_parallel() || !unittest_cache()) {
+        return 1;
+    }
+    return 0;
 }
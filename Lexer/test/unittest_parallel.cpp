@@ -0,0 +1,259 @@
+#include "unittest.hpp"
+#include "../src/ctre/dfa/array_dfa.hpp"
+#include "../src/MappedScanner.hpp"
+#include "../src/ParallelScanner.hpp"
+#include "../src/ThreadPool.hpp"
+#include "../src/Scanner.hpp"
+#include "../src/SpscRing.hpp"
+#include "../src/Pipeline.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cp;
+using namespace std;
+
+namespace {
+
+using TokenDFA = array_dfa_2d<TokenSpec>;
+
+// test thread-pool，工作线程内嵌套提交的任务与外部提交的任务同时出入队列，
+// 任务计数曾在入队之后才增加，被提前取走的任务使计数减为负数；每个任务都应恰好执行一次
+bool test_thread_pool() {
+    atomic<size_t> done = 0;
+    for (int round = 0; round < 50; round++) {
+        ThreadPool pool(4);
+        for (int i = 0; i < 200; i++) {
+            pool.submit([&] {
+                pool.submit([&] { done += 1; });
+                done += 1;
+            });
+        }
+    }
+    if (done != 50 * 200 * 2) {
+        cerr << "ThreadPool ran " << done << " of " << 50 * 200 * 2 << " tasks" << endl;
+        return false;
+    }
+    return true;
+}
+
+// test parallel-scanner，源文件多于在途上限时陆续提交，结果仍按源文件的顺序交付，
+// 每个源文件的词素与文本都应与单独的MappedScanner相同，打开失败的源文件没有词素
+bool same_tokens(const ParallelScanner<TokenDFA>::SourceTokens& tokens, const fs::path& path) {
+    MappedScanner<TokenDFA> mapped({ path }, tokens.source());
+    if (tokens.opened() != mapped.failures().empty()) {
+        return false;
+    }
+    for (const auto& batch : tokens.batches()) {
+        for (size_t i = 0; i < batch.size(); i++) {
+            const auto expected = mapped.nextLexeme();
+            const auto& actual = batch[i];
+            if (actual.label != expected.label || actual.source != expected.source || actual.offset != expected.offset
+                || actual.length != expected.length || tokens.view(actual) != mapped.view(expected)) {
+                return false;
+            }
+        }
+    }
+    return mapped.nextLexeme().length == 0;
+}
+
+template <class... Paths>
+bool parallel_as_mapped(size_t threads, const Paths&... paths) {
+    const vector<fs::path> sources = { paths... };
+    ParallelScanner<TokenDFA> scanner({ paths... }, threads);
+    size_t next = 0;
+    bool ok = true;
+    scanner.run([&](const ParallelScanner<TokenDFA>::SourceTokens& tokens) {
+        ok = ok && tokens.source() == next && same_tokens(tokens, sources[next]);
+        next += 1;
+    });
+    return ok && next == sources.size();
+}
+
+bool test_parallel(mt19937& rng) {
+    // p[2]不存在，p[3]为空；单线程时在途上限为4，其余源文件在交付时陆续提交
+    const vector<fs::path> p = { temp_path("par_a"), temp_path("par_b"), temp_path("par_missing"), temp_path("par_c"),
+        temp_path("par_d"), temp_path("par_e"), temp_path("par_f") };
+    for (const auto& path : p) {
+        if (path != p[2]) {
+            write_file(path, generate(rng, path == p[3] ? 0 : rng() % 50000));
+        }
+    }
+    const auto result = parallel_as_mapped(1, p[0], p[1], p[2], p[3], p[4], p[5], p[6])
+        && parallel_as_mapped(2, p[6], p[5], p[4], p[3], p[2], p[1], p[0])
+        && parallel_as_mapped(4, p[2], p[0])
+        && parallel_as_mapped(3);
+    for (const auto& path : p) {
+        fs::remove(path);
+    }
+    if (!result) {
+        cerr << "ParallelScanner disagrees with MappedScanner" << endl;
+    }
+    return result;
+}
+
+// test spsc-ring，容量为4的队列上传递十万个数，下标多次回绕后仍按发布的顺序到达；
+// 关闭后消费者取完剩余的数才得到结束信号
+bool test_ring_order() {
+    constexpr size_t count = 100000;
+    SpscRing<size_t, 4> ring;
+    thread producer([&] {
+        for (size_t i = 0; i < count; i++) {
+            const auto slot = ring.acquire();
+            if (slot == nullptr) {
+                return;
+            }
+            *slot = i;
+            ring.publish();
+        }
+        ring.close();
+    });
+    size_t expected = 0;
+    for (auto slot = ring.front(); slot != nullptr; slot = ring.front()) {
+        if (*slot != expected) {
+            ring.cancel(); // 使生产者退出，而不是等待永远不会归还的槽
+            break;
+        }
+        expected += 1;
+        ring.release();
+    }
+    producer.join();
+    return expected == count;
+}
+
+// 队列满时生产者停在acquire中，消费者归还一个槽后才能再发布一个；消费者取消时等待中的生产者退出
+bool test_ring_backpressure() {
+    SpscRing<int, 4> ring;
+    atomic<int> published = 0;
+    thread producer([&] {
+        for (int* slot; (slot = ring.acquire()) != nullptr; published += 1) {
+            *slot = published;
+            ring.publish();
+        }
+    });
+    auto settle = [&](int expected) {
+        while (published < expected) {
+            this_thread::yield();
+        }
+        this_thread::sleep_for(chrono::milliseconds(20)); // 给生产者越过上限的机会
+        return published == expected;
+    };
+    auto ok = settle(4);
+    ok = ok && *ring.front() == 0;
+    ring.release();
+    ok = ok && settle(5);
+    ring.cancel();
+    producer.join();
+    return ok;
+}
+
+bool test_ring_drain() {
+    SpscRing<int, 4> ring;
+    for (int i = 0; i < 3; i++) {
+        *ring.acquire() = i;
+        ring.publish();
+    }
+    ring.close();
+    for (int i = 0; i < 3; i++) {
+        const auto slot = ring.front();
+        if (slot == nullptr || *slot != i) {
+            return false;
+        }
+        ring.release();
+    }
+    return ring.front() == nullptr && ring.front() == nullptr;
+}
+
+bool test_ring() {
+    if (!test_ring_order() || !test_ring_backpressure() || !test_ring_drain()) {
+        cerr << "SpscRing loses, reorders or overruns its slots" << endl;
+        return false;
+    }
+    return true;
+}
+
+// test pipeline，经流水线取得的词素与文本应与MappedScanner逐个相同；
+// Text为true时文本随批次复制，Scanner的块很小，只保留最近一个词素的文本
+template <class Scanner, bool Text>
+bool pipeline_as_mapped(const fs::path& path) {
+    MappedScanner<TokenDFA> mapped({ path });
+    Pipeline<Scanner, Text, 2> pipeline({ path });
+    bool ok = true;
+    pipeline.run([&](const auto& batch) {
+        for (size_t i = 0; i < batch.tokens.size() && ok; i++) {
+            const auto expected = mapped.nextLexeme();
+            const auto actual = batch.tokens[i];
+            ok = actual.label == expected.label && actual.offset == expected.offset && actual.length == expected.length;
+            if constexpr (Text) {
+                ok = ok && batch.view(i) == mapped.view(expected);
+            }
+        }
+    });
+    return ok && mapped.nextLexeme().length == 0;
+}
+
+// 扫描batches批词素后抛出异常的扫描器，每批只有一个词素
+class ThrowingScanner {
+public:
+    ThrowingScanner(initializer_list<fs::path>, size_t batches) : m_batches(batches) {}
+
+    size_t scan(TokenBatch& batch) {
+        if (m_batches == 0) {
+            throw runtime_error("scanner failed");
+        }
+        m_batches -= 1;
+        batch.clear();
+        batch.push(1, 0, 0, 1);
+        return 1;
+    }
+
+private:
+    size_t m_batches;
+};
+
+// 扫描线程中的异常在交付完之前的批次后由next抛出；
+// 消费者抛出异常时队列已满，析构须让等待中的扫描线程退出
+bool test_pipeline_errors() {
+    size_t delivered = 0;
+    try {
+        Pipeline<ThrowingScanner> pipeline({}, size_t(5));
+        pipeline.run([&](const auto&) { delivered += 1; });
+        return false;
+    } catch (const runtime_error& error) {
+        if (delivered != 5 || string(error.what()) != "scanner failed") {
+            return false;
+        }
+    }
+    try {
+        Pipeline<ThrowingScanner, false, 2> pipeline({}, size_t(100));
+        pipeline.run([](const auto&) { throw logic_error("consumer failed"); });
+        return false;
+    } catch (const logic_error&) {
+        return true;
+    }
+}
+
+bool test_pipeline(mt19937& rng) {
+    const auto path = temp_path("pipeline");
+    write_file(path, generate(rng, 100000));
+    const auto result = pipeline_as_mapped<MappedScanner<TokenDFA>, false>(path)
+        && pipeline_as_mapped<MappedScanner<TokenDFA>, true>(path)
+        && pipeline_as_mapped<Scanner<TokenDFA, 16>, true>(path)
+        && test_pipeline_errors();
+    fs::remove(path);
+    if (!result) {
+        cerr << "Pipeline disagrees with MappedScanner or loses an exception" << endl;
+    }
+    return result;
+}
+
+}
+
+bool unittest_parallel() {
+    mt19937 rng(7);
+    return test_thread_pool() && test_parallel(rng) && test_ring() && test_pipeline(rng);
+}
@@ -0,0 +1,190 @@
+#include "unittest.hpp"
+#include "../src/ctre/dfa/array_dfa.hpp"
+#include "../src/ctre/dfa/runtime_dfa.hpp"
+#include "../src/ctre/regex/runtime_regex.hpp"
+#include "../src/Matcher.hpp"
+#include "../src/Scanner.hpp"
+#include "../src/TokenCache.hpp"
+#include <random>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cp;
+using namespace std;
+
+namespace {
+
+vector<runtime_transition> runtime_transitions(const fixed_transition* first, const fixed_transition* last) {
+    vector<runtime_transition> result;
+    for (; first != last; first++) {
+        result.push_back({ first->from, first->cond, first->to });
+    }
+    return result;
+}
+
+// 与unittest.hpp中的编译期状态机相同的运行期状态机，分别由转换列表与正则规则构造
+struct RuntimeDragonSpec {
+    static runtime_dfa build() {
+        return runtime_dfa::min_dfa(runtime_dfa::from_transitions(
+            runtime_transitions(DragonTransitions.data(), DragonTransitions.data() + DragonTransitions.size()), 0, { 0, 0, 0, 0, 1 }));
+    }
+};
+struct RegexDragonSpec {
+    static runtime_dfa build() {
+        return make_runtime_dfa({ { "(a|b)*abb", 1 } });
+    }
+};
+struct RuntimeTokenSpec {
+    static runtime_dfa build() {
+        return runtime_dfa::min_dfa(runtime_dfa::from_transitions(
+            runtime_transitions(TokenTransitions.data(), TokenTransitions.data() + TokenTransitions.size()), 0, { 0, 1, 2, 1, 3, 4, 5, 0, 3, 6 }));
+    }
+};
+// 同时匹配多条规则时标签按位并，故标识符的规则排除了if本身
+struct RegexTokenSpec {
+    static runtime_dfa build() {
+        return make_runtime_dfa({
+            { "i|i[ix01][ifx01]*|if[ifx01]+|[fx][ifx01]*", 1 }, { "if", 2 }, { "[01]+(\\.[01]+)?", 3 }, { " +", 4 }, { "<", 5 }, { "<=", 6 } });
+    }
+};
+
+// test runtime-fingerprint，指纹相同即状态机同构：标签与全部256个字节上的转换都一致
+template <class Runtime, class Static>
+bool same_fingerprint() {
+    return TokenCache::fingerprintOf<runtime_array_dfa<Runtime>>() == TokenCache::fingerprintOf<array_dfa_2d<Static>>();
+}
+
+bool test_fingerprint() {
+    if (!same_fingerprint<RuntimeDragonSpec, FixedSpec>() || !same_fingerprint<RegexDragonSpec, FixedSpec>()
+        || !same_fingerprint<RuntimeTokenSpec, TokenSpec>() || !same_fingerprint<RegexTokenSpec, TokenSpec>()) {
+        cerr << "runtime DFA fingerprint differs from array_dfa_2d" << endl;
+        return false;
+    }
+    if (same_fingerprint<RuntimeDragonSpec, TokenSpec>()) {
+        cerr << "different DFAs share a fingerprint" << endl;
+        return false;
+    }
+    return true;
+}
+
+// test runtime-union，与unittest_dfa.cpp中FixedUnionSpec的检查相同
+bool test_union() {
+    const auto lhs = runtime_dfa::from_transitions({ { 0, 'a', 1 } }, 0, { 0, 1 });
+    const auto rhs = runtime_dfa::from_transitions({ { 0, 'a', 1 }, { 0, 'b', 1 } }, 0, { 0, 2 });
+    const auto united = runtime_dfa::union_dfa(lhs, rhs);
+    const auto minimal = runtime_dfa::min_dfa(united);
+    const auto& next = minimal.next[minimal.initial_state];
+    const auto dragon = runtime_dfa::from_transitions(
+        runtime_transitions(DragonTransitions.data(), DragonTransitions.data() + DragonTransitions.size()), 0, { 0, 0, 0, 0, 1 });
+    // 合并后'a'与'b'到达不同的接受状态，最小化不改变状态数；图3-36最小化时A与C合并
+    const auto ok = united.states_size() == 3 && minimal.states_size() == 3
+        && minimal.labels[next['a']] == 3 && minimal.labels[next['b']] == 2 && next['c'] == 0
+        && dragon.states_size() == 5 && runtime_dfa::min_dfa(dragon).states_size() == 4
+        && minimal.next == make_runtime_dfa({ { "a", 1 }, { "a|b", 2 } }).next;
+    if (!ok) {
+        cerr << "runtime union_dfa/min_dfa gives a wrong result" << endl;
+    }
+    return ok;
+}
+
+// test runtime-matcher，运行期转换表上的最长匹配应与array_dfa_2d逐个相同
+template <class Runtime, class Static>
+bool same_matches(mt19937& rng, const char* alphabet) {
+    const auto alphabet_size = char_traits<char>::length(alphabet);
+    for (int round = 0; round < 200; round++) {
+        string text;
+        for (auto length = rng() % 200; length != 0; length--) {
+            text += alphabet[rng() % alphabet_size];
+        }
+        Matcher<runtime_array_dfa<Runtime>> runtime;
+        Matcher<array_dfa_2d<Static>> fixed;
+        const auto last = text.data() + text.size();
+        for (auto first = text.data(); first != last; ) {
+            const auto expected = fixed.match(first, last);
+            if (runtime.match(first, last) != expected) {
+                return false;
+            }
+            first += expected.second;
+        }
+    }
+    return true;
+}
+
+bool test_matcher(mt19937& rng) {
+    if (!same_matches<RegexTokenSpec, TokenSpec>(rng, "iifx01. <=?\xFF") || !same_matches<RuntimeDragonSpec, FixedSpec>(rng, "aabbc")) {
+        cerr << "Matcher on runtime_array_dfa disagrees with array_dfa_2d" << endl;
+        return false;
+    }
+    return true;
+}
+
+// test runtime-scanner，运行期转换表没有哨兵，Scanner每次前进都须显式检查块的边界。
+// 块只有16字节，长的词素与需要回溯的"0."总会跨越块边界
+template <class Scanner>
+bool scanner_as_matcher(const fs::path& path, const string& text) {
+    Matcher<runtime_array_dfa<RegexTokenSpec>> matcher;
+    Scanner scanner({ path });
+    const auto last = text.data() + text.size();
+    for (auto first = text.data(); first != last; ) {
+        const auto [label, length] = matcher.match(first, last);
+        const auto lexeme = scanner.nextLexeme();
+        if (lexeme.label != label || lexeme.offset != static_cast<uint64_t>(first - text.data()) || lexeme.length != length) {
+            return false;
+        }
+        first += length;
+    }
+    return scanner.nextLexeme().length == 0;
+}
+
+bool test_scanner(mt19937& rng) {
+    using RuntimeDFA = runtime_array_dfa<RegexTokenSpec>;
+    static_assert(!Scanner<RuntimeDFA, 16>::hasSentinel);
+    const auto path = fs::temp_directory_path() / "lexer_unittest_runtime_scanner";
+    bool ok = true;
+    for (int round = 0; round < 20 && ok; round++) {
+        string text;
+        for (auto pieces = rng() % 300; pieces != 0; pieces--) {
+            text.append(rng() % 4 == 0 ? rng() % 40 : 1, "iifx01. <=?\xFF"[rng() % 12]);
+        }
+        ofstream(path, ios::binary) << text;
+        ok = scanner_as_matcher<Scanner<RuntimeDFA, 16>>(path, text)
+            && scanner_as_matcher<Scanner<RuntimeDFA, 16, scan::Prefetch>>(path, text)
+            && scanner_as_matcher<Scanner<RuntimeDFA, 16, scan::Linear>>(path, text)
+            && scanner_as_matcher<Scanner<RuntimeDFA, 16, scan::Prefetch, scan::Linear>>(path, text);
+    }
+    fs::remove(path);
+    if (!ok) {
+        cerr << "Scanner on runtime_array_dfa disagrees with Matcher" << endl;
+    }
+    return ok;
+}
+
+// test runtime-regex-error，语法错误的消息带有出错的位置
+bool test_errors() {
+    const pair<const char*, size_t> cases[] = {
+        { "a)", 1 }, { "(ab", 3 }, { "*a", 0 }, { "a|+b", 2 }, { "a]", 1 }, { "[ab", 3 },
+        { "[b-a]", 4 }, { "[a-\\d]", 5 }, { "ab\\", 3 }, { "\\xG1", 2 }, { "[\\x4", 4 },
+    };
+    for (const auto& [pattern, position] : cases) {
+        try {
+            make_runtime_dfa({ { pattern, 1 } });
+            cerr << "runtime regex accepts \"" << pattern << '"' << endl;
+            return false;
+        } catch (const invalid_argument& error) {
+            if (string(error.what()).find(" at " + to_string(position) + " in ") == string::npos) {
+                cerr << "runtime regex reports \"" << error.what() << "\", expected position " << position << endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}
+
+bool unittest_runtime() {
+    mt19937 rng(42);
+    return test_fingerprint() && test_union() && test_matcher(rng) && test_scanner(rng) && test_errors();
+}
@@ -0,0 +1,523 @@
+#include "unittest.hpp"
+#include "../src/ctre/dfa/array_dfa.hpp"
+#include "../src/Scanner.hpp"
+#include "../src/MappedScanner.hpp"
+#include "../src/ChunkedScanner.hpp"
+#include "../src/IncrementalScanner.hpp"
+#include "../src/PushScanner.hpp"
+#include "../src/InterleavedScanner.hpp"
+#include "../src/TokenStream.hpp"
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cp;
+using namespace std;
+
+// 生成的源文件都放在临时目录下，以name区分
+fs::path temp_path(const string& name) {
+    return fs::temp_directory_path() / ("lexer_unittest_" + name);
+}
+
+void write_file(const fs::path& path, const string& text) {
+    ofstream(path, ios::binary) << text;
+}
+
+// 由词素片段拼成的随机文本，含有长的自环词素与注释、需要回溯的"0."、换行、0与0xFF字节以及无法识别的字节
+string generate(mt19937& rng, size_t bytes) {
+    static const char* const pieces[] = { "if", "iff", "x", "<", "<=", "0", "1.", "0.1", " ", "\xFF", "?", ".", "\n" };
+    string text;
+    while (text.size() < bytes) {
+        switch (rng() % 10) {
+        case 0:
+            text.append(rng() % 300, ' ');
+            break;
+        case 1:
+            text += 'x';
+            for (auto length = rng() % 300; length != 0; length--) {
+                text += "ifx01"[rng() % 5];
+            }
+            break;
+        case 2:
+            text += '?';
+            for (auto length = rng() % 1000; length != 0; length--) {
+                const auto byte = static_cast<char>(rng() % 0xFF); // 注释体中没有0xFF与'?'
+                text += byte == '?' ? '\0' : byte;
+            }
+            text += '?';
+            break;
+        case 3:
+            text += '\0';
+            break;
+        default:
+            text += pieces[rng() % size(pieces)];
+        }
+    }
+    text.resize(bytes);
+    return text;
+}
+
+namespace {
+
+using TokenDFA = array_dfa_2d<TokenSpec>;
+using StacklessDFA = array_dfa_2d<StacklessSpec>;
+
+// 在TokenSpec上增加注释\?[^?\xFF]*\?(7)。注释体覆盖了0xFF以外的所有字节，于是哨兵是0xFF，
+// 输入中真实的0xFF须与哨兵区分开；注释可以长于扫描器的块，未闭合的注释需要回溯
+struct CommentSpec {
+    constexpr static auto build() {
+        std::array<fixed_transition, TokenTransitions.size() + 256> transitions{};
+        size_t size = 0;
+        for (const auto& t : TokenTransitions) {
+            transitions[size++] = t;
+        }
+        transitions[size++] = { 0, '?', 10 };
+        transitions[size++] = { 10, '?', 11 };
+        for (int byte = 0; byte < 0xFF; byte++) {
+            if (byte != '?') {
+                transitions[size++] = { 10, static_cast<char>(byte), 10 };
+            }
+        }
+        return fixed_dfa<12>::min_dfa(fixed_dfa<12>::from_transitions(transitions, 0, std::array<std::uint32_t, 12>{ 0, 1, 2, 1, 3, 4, 5, 0, 3, 6, 0, 7 }));
+    }
+};
+using CommentDFA = array_dfa_2d<CommentSpec>;
+static_assert(CommentDFA::sentinel == 0xFF && !CommentDFA::backtrack_free);
+
+// (ab)+(1)与空白(2)：ab交替的长词素没有自环，扫描只能逐字节查表，供性能测试使用
+struct ChainSpec {
+    constexpr static auto build() {
+        constexpr auto transitions = std::array<fixed_transition, 4>{ { { 0, 'a', 1 }, { 1, 'b', 2 }, { 2, 'a', 1 }, { 0, ' ', 3 } } };
+        return fixed_dfa<4>::min_dfa(fixed_dfa<4>::from_transitions(transitions, 0, std::array<std::uint32_t, 4>{ 0, 1, 1, 2 }));
+    }
+};
+using ChainDFA = array_dfa_2d<ChainSpec>;
+static_assert(ChainDFA::backtrack_free && ChainDFA::self_loops[ChainDFA::trans(ChainDFA::initial_state, 'a')].size == 0);
+
+bool same(const Lexeme& lhs, const Lexeme& rhs) {
+    return lhs.label == rhs.label && lhs.source == rhs.source && lhs.offset == rhs.offset && lhs.length == rhs.length;
+}
+
+// 作为基准的MappedScanner扫描出的全部词素，不含输入结束
+template <class ArrayDFA>
+vector<Lexeme> drain(MappedScanner<ArrayDFA>& scanner) {
+    vector<Lexeme> lexemes;
+    for (auto lexeme = scanner.nextLexeme(); lexeme.length != 0; lexeme = scanner.nextLexeme()) {
+        lexemes.push_back(lexeme);
+    }
+    return lexemes;
+}
+
+// test interleaved-scanner，词素、文本与打开失败的源文件都应与MappedScanner逐个相同
+template <class ArrayDFA, size_t Lanes, class... Paths>
+bool interleaved_as_mapped(const Paths&... paths) {
+    MappedScanner<ArrayDFA> mapped({ paths... }, 3);
+    const auto expected = drain(mapped);
+    InterleavedScanner<ArrayDFA, Lanes> interleaved({ paths... }, 3);
+    vector<Lexeme> actual;
+    interleaved.run([&](const TokenBatch& batch) {
+        for (size_t i = 0; i < batch.size(); i++) {
+            actual.push_back(batch[i]);
+        }
+    });
+    if (actual.size() != expected.size() || interleaved.failures() != mapped.failures()) {
+        return false;
+    }
+    for (size_t i = 0; i < actual.size(); i++) {
+        if (!same(actual[i], expected[i]) || interleaved.view(actual[i]) != mapped.view(expected[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class ArrayDFA>
+bool interleaved_as_mapped(const vector<fs::path>& p) {
+    // 源文件少于通道数时部分通道一开始就空闲；长短不一的源文件使通道陆续空闲
+    return interleaved_as_mapped<ArrayDFA, 4>(p[0])
+        && interleaved_as_mapped<ArrayDFA, 4>(p[0], p[1], p[2])
+        && interleaved_as_mapped<ArrayDFA, 4>(p[0], p[1], p[2], p[3], p[4], p[5])
+        && interleaved_as_mapped<ArrayDFA, 1>(p[4], p[3], p[2])
+        && interleaved_as_mapped<ArrayDFA, 3>(p[5], p[4], p[3], p[2], p[1], p[0]);
+}
+
+bool test_interleaved(mt19937& rng) {
+    // p[3]不存在，p[1]为空
+    const vector<fs::path> p = { temp_path("a"), temp_path("b"), temp_path("c"), temp_path("missing"), temp_path("d"), temp_path("e") };
+    write_file(p[0], generate(rng, 100000));
+    write_file(p[1], "");
+    write_file(p[2], generate(rng, 37));
+    write_file(p[4], generate(rng, 250000));
+    write_file(p[5], "if x1 <= 0.1 0. iff\xFF");
+    const auto result = interleaved_as_mapped<TokenDFA>(p) && interleaved_as_mapped<StacklessDFA>(p) && interleaved_as_mapped<CommentDFA>(p);
+    for (const auto& path : p) {
+        fs::remove(path);
+    }
+    if (!result) {
+        cerr << "InterleavedScanner disagrees with MappedScanner" << endl;
+    }
+    return result;
+}
+
+// MappedScanner扫描出的词素及其文本，作为其余扫描器的基准
+struct Token {
+    Lexeme lexeme;
+    string text;
+};
+
+template <class ArrayDFA>
+vector<Token> mapped_tokens(const fs::path& path) {
+    MappedScanner<ArrayDFA> scanner({ path });
+    vector<Token> tokens;
+    for (const auto& lexeme : drain(scanner)) {
+        tokens.push_back({ lexeme, scanner.str(lexeme) });
+    }
+    return tokens;
+}
+
+bool same(const vector<Token>& lhs, const vector<Token>& rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.size(); i++) {
+        if (!same(lhs[i].lexeme, rhs[i].lexeme) || lhs[i].text != rhs[i].text) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// test mapped-oracle，与MappedScanner无关的最长匹配：从每个词素起点逐字节沿ArrayDFA::trans前进直到空状态，
+// 再退回最后一个接受的位置；不用状态栈、自环跳过与失败记录，以此检查作为基准的MappedScanner本身
+template <class ArrayDFA>
+vector<Token> oracle_tokens(const string& text) {
+    vector<Token> tokens;
+    for (size_t first = 0; first < text.size(); ) {
+        Lexeme lexeme { Lexeme::invalid, 0, first, 1 };
+        auto state = ArrayDFA::initial_state;
+        for (auto forward = first; forward < text.size(); forward++) {
+            state = ArrayDFA::trans(state, text[forward]);
+            if (state == ArrayDFA::null_state) {
+                break;
+            }
+            if (ArrayDFA::label(state) != 0) {
+                lexeme.label = ArrayDFA::label(state);
+                lexeme.length = forward + 1 - first;
+            }
+        }
+        tokens.push_back({ lexeme, text.substr(first, lexeme.length) });
+        first += lexeme.length;
+    }
+    return tokens;
+}
+
+// test scanner，块很小，词素在换块时保留在保留区中，长于块的词素使保留区增长；
+// 每个词素返回后检查其文本、行列位置与驻留到符号表中的符号
+template <class Scanner, class ArrayDFA>
+bool scanner_as_mapped(const fs::path& path) {
+    const auto expected = mapped_tokens<ArrayDFA>(path);
+    Scanner scanner({ path });
+    SymbolTable symbols;
+    Position position { 1, 1 };
+    for (const auto& token : expected) {
+        const auto lexeme = scanner.nextLexeme();
+        if (!same(lexeme, token.lexeme) || scanner.view(lexeme) != token.text) {
+            return false;
+        }
+        const auto actual = scanner.position(lexeme);
+        if (actual.line != position.line || actual.column != position.column) {
+            return false;
+        }
+        if (scanner.symbol(lexeme) != symbols.intern(token.text)) {
+            return false;
+        }
+        for (const auto c : token.text) {
+            position = c == '\n' ? Position { position.line + 1, 1 } : Position { position.line, position.column + 1 };
+        }
+    }
+    return scanner.nextLexeme().length == 0;
+}
+
+// 多个源文件时的编号与打开失败的源文件，经批量接口扫描
+template <class Scanner, class ArrayDFA, class... Paths>
+bool scanner_batches_as_mapped(const Paths&... paths) {
+    MappedScanner<ArrayDFA> mapped({ paths... });
+    const auto expected = drain(mapped);
+    Scanner scanner({ paths... });
+    TokenBatch batch(7);
+    size_t i = 0;
+    while (scanner.scan(batch) != 0) {
+        for (size_t j = 0; j < batch.size(); j++, i++) {
+            if (i == expected.size() || !same(batch[j], expected[i])) {
+                return false;
+            }
+        }
+    }
+    return i == expected.size() && scanner.failures() == mapped.failures();
+}
+
+template <class ArrayDFA>
+bool test_scanner(const fs::path& path, const fs::path& other, const fs::path& missing) {
+    return scanner_as_mapped<Scanner<ArrayDFA, 16, scan::Positions, scan::Interned<1>>, ArrayDFA>(path)
+        && scanner_as_mapped<Scanner<ArrayDFA, 16, scan::Prefetch, scan::Linear, scan::Positions, scan::Interned<1>>, ArrayDFA>(path)
+        && scanner_as_mapped<Scanner<ArrayDFA, 64, scan::Interned<1, 7>, scan::Positions, scan::Prefetch>, ArrayDFA>(path)
+        && scanner_batches_as_mapped<Scanner<ArrayDFA, 16>, ArrayDFA>(path, missing, other)
+        && scanner_batches_as_mapped<Scanner<ArrayDFA, 16, scan::Prefetch, scan::Linear>, ArrayDFA>(missing, other, path);
+}
+
+// test chunked-scanner，块很小，推测的词素边界大多是错的，拼接时须从真实位置修正
+template <class ArrayDFA, bool Linear>
+bool chunked_as_mapped(const fs::path& path, size_t chunkSize) {
+    const auto expected = mapped_tokens<ArrayDFA>(path);
+    ChunkedScanner<ArrayDFA, Linear> scanner(path, 0, chunkSize, 3);
+    vector<Token> actual;
+    scanner.run([&](const TokenBatch& batch) {
+        for (size_t i = 0; i < batch.size(); i++) {
+            actual.push_back({ batch[i], scanner.str(batch[i]) });
+        }
+    });
+    return same(actual, expected);
+}
+
+template <class ArrayDFA>
+bool test_chunked(const fs::path& path) {
+    // SIZE_MAX检查块数与块尾的计算不会溢出
+    for (const size_t chunkSize : initializer_list<size_t>{ 1, 7, 100, 4096, 1 << 20, SIZE_MAX }) {
+        if (!chunked_as_mapped<ArrayDFA, false>(path, chunkSize) || !chunked_as_mapped<ArrayDFA, true>(path, chunkSize)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// test incremental-scanner，每次编辑后的词素流应与重新扫描整个文本相同，
+// 且只有Change所报告的范围发生变化，其前后的旧词素原样保留，其后的偏移随编辑平移
+template <class ArrayDFA>
+vector<Token> incremental_tokens(const IncrementalScanner<ArrayDFA>& scanner) {
+    vector<Token> tokens;
+    for (size_t i = 0; i < scanner.size(); i++) {
+        tokens.push_back({ scanner[i], scanner.str(scanner[i]) });
+    }
+    return tokens;
+}
+
+template <class ArrayDFA>
+bool test_incremental(mt19937& rng, const fs::path& path) {
+    auto text = generate(rng, 3000);
+    IncrementalScanner<ArrayDFA> scanner;
+    scanner.reset(text);
+    auto tokens = incremental_tokens(scanner);
+    for (int round = 0; round < 200; round++) {
+        const size_t offset = rng() % (text.size() + 1);
+        const size_t removed = min<size_t>(rng() % 20, text.size() - offset);
+        const auto insertion = generate(rng, rng() % 20);
+        text.replace(offset, removed, insertion);
+        const auto change = scanner.update(text, offset, removed, insertion.size());
+        const auto updated = incremental_tokens(scanner);
+        write_file(path, text);
+        if (!same(updated, mapped_tokens<ArrayDFA>(path))) {
+            return false;
+        }
+        if (updated.size() != tokens.size() - change.removed + change.inserted) {
+            return false;
+        }
+        for (size_t i = 0; i < change.first; i++) {
+            if (!same(updated[i].lexeme, tokens[i].lexeme)) {
+                return false;
+            }
+        }
+        for (size_t i = change.first + change.inserted, j = change.first + change.removed; i < updated.size(); i++, j++) {
+            auto shifted = tokens[j].lexeme;
+            shifted.offset = shifted.offset + insertion.size() - removed;
+            if (!same(updated[i].lexeme, shifted)) {
+                return false;
+            }
+        }
+        tokens = updated;
+    }
+    return true;
+}
+
+// test push-scanner，分段送入的数据，包括空段与逐字节送入，结果应与一次性扫描相同
+template <class ArrayDFA, bool Linear>
+bool push_as_mapped(mt19937& rng, const fs::path& path, const string& text, size_t maxPiece) {
+    const auto expected = mapped_tokens<ArrayDFA>(path);
+    PushScanner<ArrayDFA, Linear> scanner;
+    vector<Token> actual;
+    auto consumer = [&](const TokenBatch& batch) {
+        for (size_t i = 0; i < batch.size(); i++) {
+            actual.push_back({ batch[i], scanner.str(batch[i]) });
+        }
+    };
+    for (size_t offset = 0; offset < text.size(); ) {
+        const auto piece = min<size_t>(rng() % (maxPiece + 1), text.size() - offset);
+        scanner.feed(string_view(text).substr(offset, piece), consumer);
+        offset += piece;
+    }
+    scanner.finish(consumer);
+    return same(actual, expected);
+}
+
+template <class ArrayDFA>
+bool test_push(mt19937& rng, const fs::path& path, const string& text) {
+    return push_as_mapped<ArrayDFA, false>(rng, path, text, 1)
+        && push_as_mapped<ArrayDFA, true>(rng, path, text, 1)
+        && push_as_mapped<ArrayDFA, false>(rng, path, text, 40)
+        && push_as_mapped<ArrayDFA, true>(rng, path, text, 5000);
+}
+
+// test token-stream，范围for循环取出的词素与文本应与MappedScanner逐个相同。
+// 批大小为1时中途停止不丢失词素，新的TokenStream从停下处继续
+template <class Scanner, class ArrayDFA>
+bool stream_as_mapped(const fs::path& path, size_t batchSize) {
+    const auto expected = mapped_tokens<ArrayDFA>(path);
+    Scanner scanner({ path });
+    vector<Token> actual;
+    for (const auto& lexeme : TokenStream<Scanner>(scanner, batchSize)) {
+        actual.push_back({ lexeme, scanner.str(lexeme) });
+    }
+    return same(actual, expected);
+}
+
+template <class Scanner, class ArrayDFA>
+bool stream_resumes(const fs::path& path) {
+    const auto expected = mapped_tokens<ArrayDFA>(path);
+    Scanner scanner({ path });
+    vector<Token> actual;
+    for (const auto& lexeme : TokenStream<Scanner>(scanner, 1)) {
+        actual.push_back({ lexeme, scanner.str(lexeme) });
+        if (actual.size() == expected.size() / 2) {
+            break;
+        }
+    }
+    for (const auto& lexeme : TokenStream<Scanner>(scanner, 1)) {
+        actual.push_back({ lexeme, scanner.str(lexeme) });
+    }
+    return same(actual, expected);
+}
+
+template <class ArrayDFA>
+bool test_stream(const fs::path& path, const fs::path& empty) {
+    for (const auto& source : { path, empty }) {
+        if (!stream_as_mapped<MappedScanner<ArrayDFA>, ArrayDFA>(source, TokenBatch::defaultCapacity)
+            || !stream_as_mapped<MappedScanner<ArrayDFA>, ArrayDFA>(source, 7)
+            || !stream_as_mapped<Scanner<ArrayDFA, 16>, ArrayDFA>(source, 1)
+            || !stream_resumes<MappedScanner<ArrayDFA>, ArrayDFA>(source)
+            || !stream_resumes<Scanner<ArrayDFA, 16, scan::Prefetch>, ArrayDFA>(source)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class ArrayDFA>
+bool test_scanners(mt19937& rng, const char* name) {
+    const fs::path p[] = { temp_path("scan"), temp_path("scan_other"), temp_path("scan_missing"), temp_path("scan_edit"), temp_path("scan_empty") };
+    const auto text = generate(rng, 20000);
+    write_file(p[0], text);
+    write_file(p[1], generate(rng, 500));
+    write_file(p[4], "");
+    const auto result = same(mapped_tokens<ArrayDFA>(p[0]), oracle_tokens<ArrayDFA>(text))
+        && test_scanner<ArrayDFA>(p[0], p[1], p[2]) && test_chunked<ArrayDFA>(p[0])
+        && test_incremental<ArrayDFA>(rng, p[3]) && test_push<ArrayDFA>(rng, p[0], text)
+        && test_stream<ArrayDFA>(p[0], p[4]);
+    for (const auto& path : p) {
+        fs::remove(path);
+    }
+    if (!result) {
+        cerr << "a scanner disagrees with MappedScanner on " << name << endl;
+    }
+    return result;
+}
+
+// 扫描全部源文件所用的秒数，取三次中最快的一次
+template <class Run>
+double fastest(Run run) {
+    double best = 0;
+    for (int i = 0; i < 3; i++) {
+        const auto start = chrono::steady_clock::now();
+        run();
+        const chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+        best = i == 0 ? elapsed.count() : min(best, elapsed.count());
+    }
+    return best;
+}
+
+// 同一组源文件分别由MappedScanner与4个通道的InterleavedScanner扫描，按标签求和以免扫描被优化掉
+template <class ArrayDFA, class... Paths>
+void compare_interleaved(const char* name, const Paths&... paths) {
+    const auto bytes = (fs::file_size(paths) + ...);
+    std::uint64_t checksum[2] = {};
+    const auto mapped = fastest([&] {
+        MappedScanner<ArrayDFA> scanner({ paths... });
+        TokenBatch batch;
+        while (scanner.scan(batch) != 0) {
+            for (size_t i = 0; i < batch.size(); i++) {
+                checksum[0] += batch.labels()[i];
+            }
+        }
+    });
+    const auto interleaved = fastest([&] {
+        InterleavedScanner<ArrayDFA, 4> scanner({ paths... });
+        scanner.run([&](const TokenBatch& batch) {
+            for (size_t i = 0; i < batch.size(); i++) {
+                checksum[1] += batch.labels()[i];
+            }
+        });
+    });
+    const auto megabytes = bytes / 1e6;
+    cout << name << ": MappedScanner " << megabytes / mapped << " MB/s, InterleavedScanner " << megabytes / interleaved
+         << " MB/s, speedup " << mapped / interleaved << (checksum[0] == checksum[1] ? "" : " (checksum mismatch)") << endl;
+}
+
+}
+
+bool unittest_scanner() {
+    mt19937 rng(2024);
+    return test_interleaved(rng) && test_scanners<TokenDFA>(rng, "TokenDFA")
+        && test_scanners<StacklessDFA>(rng, "StacklessDFA") && test_scanners<CommentDFA>(rng, "CommentDFA");
+}
+
+void benchmark_scanner() {
+    // 长词素：标识符与空白的自环使每个词素长达数百字节，扫描时间主要花在逐字节的查表链上；
+    // 短词素：每个词素只有一两个字节，时间主要花在词素的结束与重启上
+    constexpr size_t size = 16 << 20;
+    mt19937 rng(7);
+    const fs::path p[] = { temp_path("bench0"), temp_path("bench1"), temp_path("bench2"), temp_path("bench3") };
+    for (const auto& path : p) {
+        string text;
+        while (text.size() < size) {
+            text += 'x';
+            text.append(rng() % 500, "ifx01"[rng() % 5]);
+            text.append(1 + rng() % 8, ' ');
+        }
+        write_file(path, text);
+    }
+    compare_interleaved<TokenDFA>("long tokens", p[0], p[1], p[2], p[3]);
+    for (const auto& path : p) {
+        string text;
+        while (text.size() < size) {
+            text += "<= 0.1 if x "[rng() % 12];
+        }
+        write_file(path, text);
+    }
+    compare_interleaved<TokenDFA>("short tokens", p[0], p[1], p[2], p[3]);
+    for (const auto& path : p) {
+        string text;
+        while (text.size() < size) {
+            for (auto length = 1 + rng() % 500; length != 0; length--) {
+                text += "ab";
+            }
+            text += ' ';
+        }
+        write_file(path, text);
+    }
+    compare_interleaved<ChainDFA>("long tokens without self-loops", p[0], p[1], p[2], p[3]);
+    for (const auto& path : p) {
+        fs::remove(path);
+    }
+}